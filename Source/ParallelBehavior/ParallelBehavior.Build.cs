@@ -26,6 +26,8 @@ public class ParallelBehavior : ModuleRules
 			new string[]
 			{
 				"Core",
+				"GameplayTags",
+				"NetCore",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -38,10 +40,14 @@ public class ParallelBehavior : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
-				"AIModule"
+				"AIModule",
+				"DeveloperSettings"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
+
+		// layer category of the gameplay debugger, compiled out where the debugger is (shipping by default)
+		SetupGameplayDebuggerSupport(Target);
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
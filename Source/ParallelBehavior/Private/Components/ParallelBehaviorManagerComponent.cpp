@@ -1,8 +1,24 @@
 ﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
 #include "Components/ParallelBehaviorManagerComponent.h"
 #include "ParallelBehavior.h"
+#include "ParallelBehaviorArchetype.h"
+#include "ParallelBehaviorAssetCache.h"
+#include "ParallelBehaviorBlackboardUtils.h"
+#include "ParallelBehaviorSquad.h"
+#include "ParallelBehaviorStats.h"
+#include "Subsystems/ParallelBehaviorSubsystem.h"
 
+#include "BehaviorTree/BehaviorTreeManager.h"
+#include "BehaviorTree/BTDecorator.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "GameplayTagAssetInterface.h"
+#include "Misc/DataValidation.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+#include "UObject/ObjectSaveContext.h"
 
 
 UParallelBehaviorManagerComponent::UParallelBehaviorManagerComponent()
@@ -12,167 +28,2324 @@ UParallelBehaviorManagerComponent::UParallelBehaviorManagerComponent()
 	SetIsReplicatedByDefault(false);
 }
 
+void UParallelBehaviorManagerComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// after the archetype's properties were copied, they point the summary at the archetype
+	LayerSummary.Owner = this;
+}
+
+void UParallelBehaviorManagerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UParallelBehaviorManagerComponent, LayerSummary);
+}
+
+
+void UParallelBehaviorManagerComponent::RunDefaultTrees()
+{
+	if (Archetype != nullptr && Archetype->ResolveSynchronous())
+	{
+		for (const FParallelBehaviorSetup& layer : Archetype->Layers)
+		{
+			if (bDeferDefaultTrees)
+			{
+				QueueTree(layer);
+			}
+			else
+			{
+				AddTree(layer);
+			}
+		}
+	}
+
+	int32 n = ParallelBehaviorDefaults.Num();
+	for (int32 i = 0; i < n; ++i)
+	{
+		if (bDeferDefaultTrees)
+		{
+			QueueTree(ParallelBehaviorDefaults[i]);
+		}
+		else
+		{
+			AddTree(ParallelBehaviorDefaults[i]);
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::RunDefaultTreesAsync()
+{
+	if (Archetype != nullptr)
+	{
+		// the archetype's request is shared with every other manager using it
+		bAwaitingArchetype = true;
+		if (!Archetype->ResolveAsync(FSimpleDelegate::CreateWeakLambda(this, [this]()
+		{
+			if (!bAwaitingArchetype || Archetype == nullptr)
+			{
+				return;
+			}
+
+			bAwaitingArchetype = false;
+			StartLoadedTrees(Archetype->Layers, bDeferDefaultTrees);
+			UpdateBehaviorReady();
+		}))
+		{
+			bAwaitingArchetype = false;
+		}
+	}
+
+	LoadTrees(ParallelBehaviorDefaults, bDeferDefaultTrees);
+}
+
+bool UParallelBehaviorManagerComponent::AddTreeAsync(const FParallelBehaviorSetup& InSetup)
+{
+	return AddTreesAsync(TArray<FParallelBehaviorSetup>{ InSetup });
+}
+
+bool UParallelBehaviorManagerComponent::AddTreesAsync(const TArray<FParallelBehaviorSetup>& InSetups)
+{
+	return LoadTrees(InSetups, false);
+}
+
+bool UParallelBehaviorManagerComponent::LoadTrees(const TArray<FParallelBehaviorSetup>& InSetups, bool bInQueue)
+{
+	TArray<FParallelBehaviorSetup> validSetups;
+	TArray<FSoftObjectPath> pathsToLoad;
+	validSetups.Reserve(InSetups.Num());
+	pathsToLoad.Reserve(InSetups.Num());
+
+	for (const FParallelBehaviorSetup& setup : InSetups)
+	{
+		if (setup.Processor != nullptr)
+		{
+			// processor layers have nothing to stream
+			validSetups.Add(setup);
+			continue;
+		}
+
+		if (setup.BTAsset.IsNull())
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("LoadTrees: Unable to run NULL behavior tree '%s'"), *setup.Id.ToString());
+			continue;
+		}
+
+		validSetups.Add(setup);
+		if (!setup.BTAsset.IsValid())
+		{
+			pathsToLoad.AddUnique(setup.BTAsset.ToSoftObjectPath());
+		}
+	}
+
+	if (validSetups.Num() == 0)
+	{
+		return false;
+	}
+
+	// Everything is already resident, no need to go through the streamable manager
+	if (pathsToLoad.Num() == 0)
+	{
+		StartLoadedTrees(validSetups, bInQueue);
+		return true;
+	}
+
+	FStreamableManager& streamable = UAssetManager::GetStreamableManager();
+	TSharedPtr<FStreamableHandle> handle = streamable.RequestAsyncLoad(MoveTemp(pathsToLoad),
+		FStreamableDelegate::CreateWeakLambda(this, [this, validSetups, bInQueue]()
+		{
+			PendingLoads.RemoveAll([](const TSharedPtr<FStreamableHandle>& InHandle)
+			{
+				return !InHandle.IsValid() || InHandle->HasLoadCompleted() || InHandle->WasCanceled();
+			});
+			StartLoadedTrees(validSetups, bInQueue);
+			UpdateBehaviorReady();
+		}));
+
+	if (handle.IsValid() && !handle->HasLoadCompleted())
+	{
+		PendingLoads.Add(handle);
+	}
+	return true;
+}
+
+void UParallelBehaviorManagerComponent::StartLoadedTrees(const TArray<FParallelBehaviorSetup>& InSetups, bool bInQueue)
+{
+	TArray<FName> startedIds;
+	startedIds.Reserve(InSetups.Num());
+	for (const FParallelBehaviorSetup& setup : InSetups)
+	{
+		if (setup.Processor == nullptr && !setup.BTAsset.IsValid())
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("StartLoadedTrees: Failed to load behavior tree '%s' for id '%s'"),
+				*setup.BTAsset.ToString(), *setup.Id.ToString());
+			continue;
+		}
+
+		if (bInQueue)
+		{
+			QueueTree(setup);
+		}
+		else if (AddTree(setup))
+		{
+			startedIds.Add(setup.Id);
+		}
+	}
+
+	if (!bInQueue)
+	{
+		OnTreesStarted.Broadcast(startedIds);
+	}
+}
+
+bool UParallelBehaviorManagerComponent::QueueTree(const FParallelBehaviorSetup& InSetup)
+{
+	UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+	if (subsystem == nullptr)
+	{
+		return AddTree(InSetup);
+	}
+
+	subsystem->EnqueueSpawn(this, InSetup);
+	++NumQueuedTrees;
+	return true;
+}
+
+void UParallelBehaviorManagerComponent::UseManagedTickForAllTrees()
+{
+	for (const FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		if (!rt.bManagedTick)
+		{
+			SetTreeTickInterval(rt.Id, rt.Setup.TickInterval);
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::CancelQueuedTrees()
+{
+	if (NumQueuedTrees > 0)
+	{
+		if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+		{
+			subsystem->CancelSpawns(this);
+		}
+	}
+	NumQueuedTrees = 0;
+}
+
+void UParallelBehaviorManagerComponent::StartQueuedTree(const FParallelBehaviorSetup& InSetup)
+{
+	NumQueuedTrees = FMath::Max(NumQueuedTrees - 1, 0);
+	AddTree(InSetup);
+	UpdateBehaviorReady();
+}
+
+void UParallelBehaviorManagerComponent::UpdateBehaviorReady()
+{
+	if (bBehaviorReady || !HasBegunPlay() || NumQueuedTrees > 0 || PendingLoads.Num() > 0 || bAwaitingArchetype)
+	{
+		return;
+	}
+
+	bBehaviorReady = true;
+	OnBehaviorReady.Broadcast();
+}
+
+void UParallelBehaviorManagerComponent::CancelPendingLoads()
+{
+	for (const TSharedPtr<FStreamableHandle>& handle : PendingLoads)
+	{
+		if (handle.IsValid())
+		{
+			handle->CancelHandle();
+		}
+	}
+	PendingLoads.Empty();
+}
+
+
+// Called when the game starts
+void UParallelBehaviorManagerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GetOwner()->HasAuthority())
+	{
+		InitializeSharedBlackboard();
+
+		UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+		if (subsystem != nullptr)
+		{
+			subsystem->RegisterManager(this);
+			if (!DefaultSquadId.IsNone())
+			{
+				JoinSquad(subsystem->FindOrCreateSquad(DefaultSquadId, SquadBlackboardAsset));
+			}
+		}
+
+		// gated default layers are activated against the tags the owner starts with
+		ReadOwnerTags(OwnerTags);
+
+		// every default layer plus the slack fits without growing the layer storage later
+		const int32 numLayers = ParallelBehaviorDefaults.Num() + (Archetype != nullptr ? Archetype->Layers.Num() : 0) + ReservedLayerSlack;
+		RunningTrees.Reserve(numLayers);
+		TreeIndexById.Reserve(numLayers);
+
+		// a manager coming back with its level continues from the snapshot it left with
+		FParallelBehaviorSnapshot snapshot;
+		if (bPersistAcrossStreaming && subsystem != nullptr && subsystem->TakeSnapshot(GetSnapshotKey(), snapshot))
+		{
+			RestoreSnapshot(snapshot);
+		}
+		else if (bLoadDefaultTreesAsync)
+		{
+			RunDefaultTreesAsync();
+		}
+		else
+		{
+			RunDefaultTrees();
+		}
+		UpdateBehaviorReady();
+
+		if (bReplicateLayerSummary)
+		{
+			SetIsReplicated(true);
+			UpdateLayerSummary();
+			GetWorld()->GetTimerManager().SetTimer(LayerSummaryTimer, this, &UParallelBehaviorManagerComponent::UpdateLayerSummary,
+				LayerSummaryUpdateInterval, true);
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelPendingLoads();
+	CancelQueuedTrees();
+	if (UWorld* world = GetWorld())
+	{
+		world->GetTimerManager().ClearTimer(LayerSummaryTimer);
+	}
+	bAwaitingArchetype = false;
+
+	if (bPersistAcrossStreaming && EndPlayReason == EEndPlayReason::RemovedFromWorld && GetOwner()->HasAuthority())
+	{
+		if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+		{
+			FParallelBehaviorSnapshot snapshot = CaptureSnapshot();
+			if (!snapshot.IsEmpty())
+			{
+				subsystem->StoreSnapshot(GetSnapshotKey(), MoveTemp(snapshot));
+			}
+		}
+	}
+	TeardownTrees(); // Ensures proper cleanup
+	EmptyPool();
+	ReleaseSharedBlackboard();
+	LeaveSquad();
+
+	if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+	{
+		subsystem->UnregisterManager(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UParallelBehaviorManagerComponent::AddTree(const FParallelBehaviorSetup& InSetup)
+{
+	return AddTreeInternal(InSetup, nullptr);
+}
+
+bool UParallelBehaviorManagerComponent::AddTreeInternal(const FParallelBehaviorSetup& InSetup, const FParallelBehaviorLayerSnapshot* InSnapshot)
+{
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_AddTree);
+
+	const bool bGated = HasActivationQueries(InSetup);
+	if (bGated && (InSetup.Processor != nullptr || InSetup.bReleaseWhenInactive) && !IsSetupActive(InSetup))
+	{
+		// same Id scheme as a started layer, generated from the asset name without loading it
+		const FName assetName = InSetup.Processor != nullptr ? InSetup.Processor->GetFName() : InSetup.BTAsset.ToSoftObjectPath().GetAssetFName();
+		if (InSetup.Id.IsNone() && assetName.IsNone())
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("AddTree: Unable to run NULL behavior tree"));
+			return false;
+		}
+
+		const FName layerId = InSetup.Id.IsNone() ? FName(assetName, ++GeneratedIdCounter) : InSetup.Id;
+		if (IsLayerIdTaken(layerId))
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("AddTree: Layer with id '%s' already exists"), *layerId.ToString());
+			return false;
+		}
+
+		// no components until the owner tags activate the layer, see ApplyOwnerTags
+		FParallelBehaviorSetup& inactiveSetup = InactiveLayers.Add_GetRef(InSetup);
+		inactiveSetup.Id = layerId;
+		UE_LOG(LogParallelBehavior, Verbose, TEXT("AddTree: '%s' is inactive for the current owner tags"), *layerId.ToString());
+		return true;
+	}
+
+	if (InSetup.Processor != nullptr)
+	{
+		return AddProcessorLayer(InSetup);
+	}
+
+	if (InSetup.BTAsset.IsNull())
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("AddTree: Unable to run NULL behavior tree"));
+		return false;
+	}
+
+	if (!InSetup.BTAsset.IsValid())
+	{
+		// Synchronous resolve, prefer AddTreeAsync on the gameplay path
+		UE_LOG(LogParallelBehavior, Verbose, TEXT("AddTree: '%s' is not loaded, loading synchronously"), *InSetup.BTAsset.ToString());
+		if (InSetup.BTAsset.LoadSynchronous() == nullptr)
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("AddTree: Failed to load behavior tree '%s'"), *InSetup.BTAsset.ToString());
+			return false;
+		}
+	}
+
+	UBehaviorTree* btAsset = InSetup.BTAsset.Get();
+
+	// generate an ID from the asset name when none was specified
+	const FName treeId = InSetup.Id.IsNone() ? FName(btAsset->GetFName(), ++GeneratedIdCounter) : InSetup.Id;
+	if (IsLayerIdTaken(treeId))
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("AddTree: Tree with id '%s' is already running"), *treeId.ToString());
+		return false;
+	}
+
+	if (btAsset->BlackboardAsset == nullptr)
+	{
+		// lean layers without a blackboard are intended, they just run without one
+		if (bLeanLayers)
+		{
+			UE_LOG(LogParallelBehavior, Verbose, TEXT("AddTree: '%s' has no Blackboard asset, running without one"), *treeId.ToString());
+		}
+		else
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("AddTree: trying to use NULL Blackboard asset. Ignoring"));
+		}
+	}
+
+	UBehaviorTreeComponent* btComp = nullptr;
+	UBlackboardComponent* blackboardComp = nullptr;
+	if (!AcquirePooledPair(btAsset, btComp, blackboardComp))
+	{
+		CreatePair(btAsset, btComp, blackboardComp);
+	}
+
+	check(btComp != nullptr);
+	// a managed tree never registers its tick function, the subsystem drives it instead
+	const UParallelBehaviorSubsystem* scheduler = GetParallelBehaviorSubsystem();
+	const bool bManagedTick = bUseManagedTick || InSetup.TickInterval > 0.0f || (scheduler != nullptr && scheduler->IsStepMode());
+	btComp->PrimaryComponentTick.bCanEverTick = !bManagedTick;
+	btComp->RegisterComponent();
+	if (blackboardComp != nullptr)
+	{
+		PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_BlackboardInit);
+		blackboardComp->RegisterComponent();
+
+		// make sure the brain talks to its own blackboard and not the first one found on the owner
+		btComp->CacheBlackboardComponent(blackboardComp);
+		blackboardComp->CacheBrainComponent(*btComp);
+
+		// find the "self" key and set it to our pawn, resolved once per blackboard asset
+		const FParallelBehaviorBlackboardLayout& layout = FParallelBehaviorAssetCache::Get().GetLayout(*btAsset->BlackboardAsset);
+		if (layout.SelfKey != FBlackboard::InvalidKey)
+		{
+			blackboardComp->SetValue<UBlackboardKeyType_Object>(layout.SelfKey, GetPawn());
+		}
+
+		if (InSnapshot != nullptr && InSnapshot->BlackboardAsset == btAsset->BlackboardAsset)
+		{
+			// restored values replace the initial ones, mirrored keys then take the current shared values
+			RestoreBlackboardValues(*blackboardComp, layout, *InSnapshot);
+			SyncSharedValues(*blackboardComp);
+		}
+		else
+		{
+			// seed mirrored keys and the setup's initial values before the first evaluation
+			SyncSharedValues(*blackboardComp);
+			if (InSetup.InitialValues.Num() > 0)
+			{
+				ApplyValuesBatched(*blackboardComp, InSetup.InitialValues, false);
+			}
+		}
+		if (InSetup.WakeKeys.Num() > 0)
+		{
+			RegisterWakeKeys(*blackboardComp, InSetup);
+		}
+	}
+
+	btComp->StartTree(*btAsset, EBTExecutionMode::Looped);
+
+	FParallelBehaviorRuntime runtime(treeId, btComp, blackboardComp);
+	runtime.BTAsset = btAsset;
+	runtime.bManagedTick = bManagedTick;
+	runtime.Setup = InSetup;
+	runtime.Setup.Id = treeId;
+	if (bLeanLayers)
+	{
+		// only needed before the first evaluation
+		runtime.Setup.InitialValues.Empty();
+	}
+
+	UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+	if (subsystem != nullptr)
+	{
+		runtime.LayerHandle = subsystem->RegisterLayer(this, treeId, btComp, blackboardComp);
+		if (InSetup.TickCondition != nullptr)
+		{
+			subsystem->SetLayerTickCondition(runtime.LayerHandle, InSetup.TickCondition, InSetup.bThreadSafe);
+		}
+		if (bManagedTick)
+		{
+			subsystem->SetLayerManagedTick(runtime.LayerHandle, InSetup.TickInterval, InSetup.Priority, InSetup.bRandomTickPhase);
+		}
+	}
+
+	AssignMessageSlot(runtime);
+
+	const int32 newIndex = RunningTrees.Add(MoveTemp(runtime));
+	TreeIndexById.Add(treeId, newIndex);
+
+	if (subsystem != nullptr && subsystem->IsWorldPaused())
+	{
+		AddPauseReason(RunningTrees[newIndex], EParallelBehaviorPauseReason::World);
+	}
+	if (bAllPaused)
+	{
+		AddPauseReason(RunningTrees[newIndex], EParallelBehaviorPauseReason::User);
+	}
+	if (bEnableLOD)
+	{
+		ApplyLOD(RunningTrees[newIndex]);
+	}
+	if (bGated && !IsSetupActive(InSetup))
+	{
+		AddPauseReason(RunningTrees[newIndex], EParallelBehaviorPauseReason::Tags);
+	}
+
+	UE_LOG(LogParallelBehavior, Verbose, TEXT("AddTree: Started tree '%s' with blackboard '%s'"), *GetNameSafe(btAsset),
+		*GetNameSafe(btAsset->BlackboardAsset));
+	return true;
+}
+
+void UParallelBehaviorManagerComponent::CreatePair(UBehaviorTree* InBTAsset,
+	UBehaviorTreeComponent*& OutTreeComponent, UBlackboardComponent*& OutBlackboardComponent)
+{
+	// pooled pairs serve any layer of their asset, so names carry a number instead of the layer Id
+	static const FName BlackboardComponentName(TEXT("ParallelBlackboardComponent"));
+	static const FName TreeComponentName(TEXT("ParallelBehaviorTreeComponent"));
+
+	OutBlackboardComponent = nullptr;
+	if (InBTAsset->BlackboardAsset != nullptr)
+	{
+		OutBlackboardComponent = NewObject<UBlackboardComponent>(this, FName(BlackboardComponentName, ++ComponentNameCounter));
+		if (OutBlackboardComponent != nullptr)
+		{
+			PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_BlackboardInit);
+			OutBlackboardComponent->InitializeBlackboard(*InBTAsset->BlackboardAsset);
+		}
+	}
+
+	OutTreeComponent = NewObject<UBehaviorTreeComponent>(this, FName(TreeComponentName, ++ComponentNameCounter));
+}
+
+bool UParallelBehaviorManagerComponent::AcquirePooledPair(const UBehaviorTree* InBTAsset,
+	UBehaviorTreeComponent*& OutTreeComponent, UBlackboardComponent*& OutBlackboardComponent)
+{
+	for (int32 i = ComponentPool.Num() - 1; i >= 0; --i)
+	{
+		FParallelBehaviorPooledPair& pair = ComponentPool[i];
+		if (pair.BTAsset == InBTAsset && pair.BlackboardAsset == InBTAsset->BlackboardAsset
+			&& IsValid(pair.TreeComponent))
+		{
+			OutTreeComponent = pair.TreeComponent;
+			OutBlackboardComponent = pair.BlackboardComponent;
+			ComponentPool.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			DEC_DWORD_STAT(STAT_ParallelBehavior_PooledPairs);
+			return true;
+		}
+	}
+	return false;
+}
+
+EBTStopMode::Type UParallelBehaviorManagerComponent::ResolveStopMode(const FParallelBehaviorSetup& InSetup, EParallelBehaviorStopMode InStopMode)
+{
+	const EParallelBehaviorStopMode stopMode = InStopMode == EParallelBehaviorStopMode::Default ? InSetup.StopMode : InStopMode;
+	return stopMode == EParallelBehaviorStopMode::Forced ? EBTStopMode::Forced : EBTStopMode::Safe;
+}
+
+void UParallelBehaviorManagerComponent::ReleasePair(FParallelBehaviorRuntime& InRuntime, EParallelBehaviorStopMode InStopMode, bool bInDeferDestroy)
+{
+	UBehaviorTreeComponent* btComp = InRuntime.TreeComponent.Get();
+	UBlackboardComponent* blackboardComp = InRuntime.BlackboardComponent.Get();
+	UBehaviorTree* btAsset = InRuntime.BTAsset.Get();
+
+	if (btComp != nullptr)
+	{
+		if (InRuntime.PauseReasons != EParallelBehaviorPauseReason::None)
+		{
+			// a recycled pair must not come back paused
+			btComp->ResumeLogic(TEXT("ParallelBehavior"));
+		}
+		btComp->StopTree(ResolveStopMode(InRuntime.Setup, InStopMode));
+	}
+
+	if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+	{
+		subsystem->UnregisterLayer(InRuntime.LayerHandle);
+	}
+	if (blackboardComp != nullptr && InRuntime.Setup.WakeKeys.Num() > 0)
+	{
+		blackboardComp->UnregisterObserversFrom(this);
+	}
+	InRuntime.bSleeping = false;
+	ReleaseMessageSlot(InRuntime);
+
+	if (btComp != nullptr && btAsset != nullptr && CountPooledPairs(btAsset) < MaxPooledPairsPerAsset)
+	{
+		// keep the pair initialized but out of the world until the next AddTree with the same asset
+		btComp->UnregisterComponent();
+		if (blackboardComp != nullptr)
+		{
+			ResetBlackboardValues(*blackboardComp);
+			blackboardComp->UnregisterComponent();
+		}
+
+		FParallelBehaviorPooledPair& pair = ComponentPool.AddDefaulted_GetRef();
+		pair.BTAsset = btAsset;
+		pair.BlackboardAsset = btAsset->BlackboardAsset;
+		pair.TreeComponent = btComp;
+		pair.BlackboardComponent = blackboardComp;
+		INC_DWORD_STAT(STAT_ParallelBehavior_PooledPairs);
+		return;
+	}
+
+	DestroyPair(btComp, blackboardComp, bInDeferDestroy);
+}
+
+void UParallelBehaviorManagerComponent::DestroyPair(UBehaviorTreeComponent* InTreeComponent, UBlackboardComponent* InBlackboardComponent,
+	bool bInDefer)
+{
+	UParallelBehaviorSubsystem* subsystem = bInDefer ? GetParallelBehaviorSubsystem() : nullptr;
+	if (subsystem != nullptr)
+	{
+		subsystem->DeferDestroy(InTreeComponent);
+		subsystem->DeferDestroy(InBlackboardComponent);
+		return;
+	}
+
+	if (InTreeComponent != nullptr)
+	{
+		InTreeComponent->DestroyComponent();
+	}
+	if (InBlackboardComponent != nullptr)
+	{
+		InBlackboardComponent->DestroyComponent();
+	}
+}
+
+void UParallelBehaviorManagerComponent::ResetBlackboardValues(UBlackboardComponent& InBlackboard)
+{
+	const UBlackboardData* blackboardAsset = InBlackboard.GetBlackboardAsset();
+	if (blackboardAsset == nullptr)
+	{
+		return;
+	}
+
+	const int32 numKeys = blackboardAsset->GetNumKeys();
+	for (int32 i = 0; i < numKeys; ++i)
+	{
+		InBlackboard.ClearValue(static_cast<FBlackboard::FKey>(i));
+	}
+}
+
+int32 UParallelBehaviorManagerComponent::CountPooledPairs(const UBehaviorTree* InBTAsset) const
+{
+	int32 count = 0;
+	for (const FParallelBehaviorPooledPair& pair : ComponentPool)
+	{
+		if (pair.BTAsset == InBTAsset)
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+int32 UParallelBehaviorManagerComponent::PrewarmPool(const FParallelBehaviorSetup& InSetup, int32 InCount)
+{
+	UBehaviorTree* btAsset = InSetup.BTAsset.LoadSynchronous();
+	if (btAsset == nullptr)
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("PrewarmPool: Unable to prewarm NULL behavior tree"));
+		return 0;
+	}
+
+	const int32 toCreate = FMath::Min(InCount, MaxPooledPairsPerAsset - CountPooledPairs(btAsset));
+	for (int32 i = 0; i < toCreate; ++i)
+	{
+		FParallelBehaviorPooledPair& pair = ComponentPool.AddDefaulted_GetRef();
+		pair.BTAsset = btAsset;
+		pair.BlackboardAsset = btAsset->BlackboardAsset;
+
+		UBehaviorTreeComponent* btComp = nullptr;
+		UBlackboardComponent* blackboardComp = nullptr;
+		CreatePair(btAsset, btComp, blackboardComp);
+		pair.TreeComponent = btComp;
+		pair.BlackboardComponent = blackboardComp;
+	}
+	INC_DWORD_STAT_BY(STAT_ParallelBehavior_PooledPairs, FMath::Max(toCreate, 0));
+	return FMath::Max(toCreate, 0);
+}
+
+void UParallelBehaviorManagerComponent::EmptyPool()
+{
+	// pooled pairs are unregistered already, an owner being destroyed takes them along
+	const AActor* owner = GetOwner();
+	if (owner != nullptr && !owner->IsActorBeingDestroyed())
+	{
+		for (const FParallelBehaviorPooledPair& pair : ComponentPool)
+		{
+			DestroyPair(IsValid(pair.TreeComponent) ? pair.TreeComponent.Get() : nullptr,
+				IsValid(pair.BlackboardComponent) ? pair.BlackboardComponent.Get() : nullptr, true);
+		}
+	}
+	DEC_DWORD_STAT_BY(STAT_ParallelBehavior_PooledPairs, ComponentPool.Num());
+	ComponentPool.Empty();
+}
+
+void UParallelBehaviorManagerComponent::StopTree(const FName& InId, EParallelBehaviorStopMode InStopMode)
+{
+	const int32 index = FindTreeIndex(InId);
+	UBehaviorTreeComponent* tree = index != INDEX_NONE ? RunningTrees[index].TreeComponent.Get() : nullptr;
+	if (tree != nullptr)
+	{
+		tree->StopTree(ResolveStopMode(RunningTrees[index].Setup, InStopMode));
+	}
+	else if (ProcessorLayers.Contains(InId))
+	{
+		// a processor layer has no execution to abort, it just stops being processed
+		PauseTree(InId);
+	}
+}
+
+void UParallelBehaviorManagerComponent::RestartTree(const FName& InId)
+{
+	if (UBehaviorTreeComponent* tree = FindTree(InId))
+	{
+		tree->RestartTree();
+	}
+	else if (ProcessorLayers.Contains(InId))
+	{
+		ResumeTree(InId);
+	}
+}
+
+bool UParallelBehaviorManagerComponent::PauseTree(const FName& InId)
+{
+	if (const FParallelBehaviorProcessorHandle* handle = ProcessorLayers.Find(InId))
+	{
+		UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+		return subsystem != nullptr && subsystem->SetProcessorLayerPaused(*handle, true);
+	}
+
+	const int32 index = FindTreeIndex(InId);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	AddPauseReason(RunningTrees[index], EParallelBehaviorPauseReason::User);
+	return true;
+}
+
+bool UParallelBehaviorManagerComponent::ResumeTree(const FName& InId)
+{
+	if (const FParallelBehaviorProcessorHandle* handle = ProcessorLayers.Find(InId))
+	{
+		UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+		return subsystem != nullptr && subsystem->SetProcessorLayerPaused(*handle, false);
+	}
+
+	const int32 index = FindTreeIndex(InId);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	RemovePauseReason(RunningTrees[index], EParallelBehaviorPauseReason::User);
+	return true;
+}
+
+bool UParallelBehaviorManagerComponent::IsTreePaused(const FName& InId) const
+{
+	if (const FParallelBehaviorProcessorHandle* handle = ProcessorLayers.Find(InId))
+	{
+		const UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+		return subsystem != nullptr && subsystem->IsProcessorLayerPaused(*handle);
+	}
+
+	const int32 index = FindTreeIndex(InId);
+	return index != INDEX_NONE && RunningTrees[index].PauseReasons != EParallelBehaviorPauseReason::None;
+}
+
+void UParallelBehaviorManagerComponent::PauseAll()
+{
+	bAllPaused = true;
+	for (FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		AddPauseReason(rt, EParallelBehaviorPauseReason::User);
+	}
+	if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+	{
+		for (const TPair<FName, FParallelBehaviorProcessorHandle>& layer : ProcessorLayers)
+		{
+			subsystem->SetProcessorLayerPaused(layer.Value, true);
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::ResumeAll()
+{
+	bAllPaused = false;
+	for (FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		RemovePauseReason(rt, EParallelBehaviorPauseReason::User);
+	}
+	if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+	{
+		for (const TPair<FName, FParallelBehaviorProcessorHandle>& layer : ProcessorLayers)
+		{
+			subsystem->SetProcessorLayerPaused(layer.Value, false);
+		}
+	}
+}
+
+bool UParallelBehaviorManagerComponent::SleepTree(const FName& InId)
+{
+	const int32 index = FindTreeIndex(InId);
+	UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+	if (index == INDEX_NONE || subsystem == nullptr)
+	{
+		return false;
+	}
+
+	FParallelBehaviorRuntime& rt = RunningTrees[index];
+	if (rt.bSleeping)
+	{
+		return true;
+	}
+
+	// only the scheduler can hold a tree back reliably, the tree's own tick re-enables itself
+	if (!rt.bManagedTick && !ApplyTickInterval(rt, rt.Setup.TickInterval))
+	{
+		return false;
+	}
+
+	rt.bSleeping = true;
+	subsystem->SetLayerSleeping(rt.LayerHandle, true);
+	UE_LOG(LogParallelBehavior, Verbose, TEXT("SleepTree: Tree '%s' sleeps"), *InId.ToString());
+	return true;
+}
+
+bool UParallelBehaviorManagerComponent::WakeTree(const FName& InId)
+{
+	const int32 index = FindTreeIndex(InId);
+	if (index == INDEX_NONE || !RunningTrees[index].bSleeping)
+	{
+		return false;
+	}
+
+	WakeRuntime(RunningTrees[index]);
+	return true;
+}
+
+bool UParallelBehaviorManagerComponent::IsTreeSleeping(const FName& InId) const
+{
+	const int32 index = FindTreeIndex(InId);
+	return index != INDEX_NONE && RunningTrees[index].bSleeping;
+}
+
+int32 UParallelBehaviorManagerComponent::NotifyGameplayEvent(FGameplayTag InEventTag)
+{
+	int32 woken = 0;
+	for (FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		if (rt.bSleeping && rt.Setup.WakeTags.HasTag(InEventTag))
+		{
+			WakeRuntime(rt);
+			++woken;
+		}
+	}
+	return woken;
+}
+
+void UParallelBehaviorManagerComponent::WakeRuntime(FParallelBehaviorRuntime& InRuntime)
+{
+	InRuntime.bSleeping = false;
+	if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+	{
+		subsystem->SetLayerSleeping(InRuntime.LayerHandle, false);
+	}
+	UE_LOG(LogParallelBehavior, Verbose, TEXT("WakeTree: Tree '%s' woke up"), *InRuntime.Id.ToString());
+}
+
+void UParallelBehaviorManagerComponent::RegisterWakeKeys(UBlackboardComponent& InBlackboard, const FParallelBehaviorSetup& InSetup)
+{
+	const UBlackboardData* blackboardAsset = InBlackboard.GetBlackboardAsset();
+	if (blackboardAsset == nullptr)
+	{
+		return;
+	}
+
+	TArray<FBlackboard::FKey> keys;
+	FParallelBehaviorAssetCache::Get().ResolveKeys(*blackboardAsset, InSetup.WakeKeys, keys);
+	for (const FBlackboard::FKey key : keys)
+	{
+		if (key != FBlackboard::InvalidKey)
+		{
+			InBlackboard.RegisterObserver(key, this,
+				FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnWakeKeyChanged));
+		}
+	}
+}
+
+EBlackboardNotificationResult UParallelBehaviorManagerComponent::OnWakeKeyChanged(const UBlackboardComponent& InBlackboard,
+	FBlackboard::FKey InKey)
+{
+	// observers stay registered for the lifetime of the layer, waking an awake layer is a no-op
+	for (FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		if (rt.bSleeping && rt.BlackboardComponent.Get() == &InBlackboard)
+		{
+			WakeRuntime(rt);
+			break;
+		}
+	}
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
+FName UParallelBehaviorManagerComponent::FindTreeId(const UBehaviorTreeComponent* InTreeComponent) const
+{
+	for (const FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		if (rt.TreeComponent.Get() == InTreeComponent)
+		{
+			return rt.Id;
+		}
+	}
+	return NAME_None;
+}
+
+void UParallelBehaviorManagerComponent::AssignMessageSlot(FParallelBehaviorRuntime& InRuntime)
+{
+	if (UsedMessageSlots == MAX_uint64)
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("AssignMessageSlot: Tree '%s' cannot receive messages, a manager supports %d of them"),
+			*InRuntime.Id.ToString(), MaxMessageSlots);
+		return;
+	}
+
+	const int32 slot = static_cast<int32>(FMath::CountTrailingZeros64(~UsedMessageSlots));
+	const uint64 bit = 1ull << slot;
+	UsedMessageSlots |= bit;
+	MessageSlotIds[slot] = InRuntime.Id;
+	PendingMessages[slot] = 0;
+	InRuntime.MessageSlot = slot;
+
+	for (const FGameplayTag& tag : InRuntime.Setup.MessageTags)
+	{
+		MessageSubscribers.FindOrAdd(tag) |= bit;
+	}
+}
+
+void UParallelBehaviorManagerComponent::ReleaseMessageSlot(FParallelBehaviorRuntime& InRuntime)
+{
+	const int32 slot = InRuntime.MessageSlot;
+	if (slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	const uint64 bit = 1ull << slot;
+	for (int32 i = 0; i < MessageCount; ++i)
+	{
+		MessageRecipients[(MessageHead + i) % MessageRing.Num()] &= ~bit;
+	}
+	for (auto it = MessageSubscribers.CreateIterator(); it; ++it)
+	{
+		it->Value &= ~bit;
+		if (it->Value == 0)
+		{
+			it.RemoveCurrent();
+		}
+	}
+	const UBehaviorTreeComponent* layerTree = InRuntime.TreeComponent.Get();
+	MessageWatchers.RemoveAllSwap([layerTree](const FParallelBehaviorMessageWatcher& InWatcher)
+	{
+		return InWatcher.TreeComponent.Get() == layerTree;
+	});
+
+	UsedMessageSlots &= ~bit;
+	MessageSlotIds[slot] = NAME_None;
+	PendingMessages[slot] = 0;
+	InRuntime.MessageSlot = INDEX_NONE;
+	CompactMessages();
+}
+
+int32 UParallelBehaviorManagerComponent::PostMessage(const FParallelBehaviorMessage& InMessage, FName InTargetLayer)
+{
+	uint64 recipients = 0;
+	if (!InTargetLayer.IsNone())
+	{
+		const int32 slot = GetMessageSlot(InTargetLayer);
+		recipients = slot != INDEX_NONE ? 1ull << slot : 0;
+	}
+	else
+	{
+		// subscribers of the type and of every parent tag
+		for (FGameplayTag tag = InMessage.Type; tag.IsValid(); tag = tag.RequestDirectParent())
+		{
+			if (const uint64* subscribers = MessageSubscribers.Find(tag))
+			{
+				recipients |= *subscribers;
+			}
+		}
+	}
+
+	if (recipients == 0)
+	{
+		return 0;
+	}
+
+	if (MessageRing.Num() != MessageCapacity)
+	{
+		// allocated once, messages are copied into place from then on
+		MessageRing.Reset();
+		MessageRing.SetNum(FMath::Max(MessageCapacity, 1));
+		MessageRecipients.Init(0, MessageRing.Num());
+		MessageHead = 0;
+		MessageCount = 0;
+		FMemory::Memzero(PendingMessages, sizeof(PendingMessages));
+	}
+
+	if (MessageCount == MessageRing.Num())
+	{
+		UE_LOG(LogParallelBehavior, Verbose, TEXT("PostMessage: Message ring of '%s' is full, dropping the oldest message"), *GetNameSafe(GetOwner()));
+		DropOldestMessage();
+	}
+
+	const int32 ringIndex = (MessageHead + MessageCount) % MessageRing.Num();
+	MessageRing[ringIndex] = InMessage;
+	MessageRecipients[ringIndex] = recipients;
+	++MessageCount;
+
+	int32 numRecipients = 0;
+	for (uint64 bits = recipients; bits != 0; bits &= bits - 1)
+	{
+		const int32 slot = static_cast<int32>(FMath::CountTrailingZeros64(bits));
+		++PendingMessages[slot];
+		++numRecipients;
+
+		const int32* index = TreeIndexById.Find(MessageSlotIds[slot]);
+		if (index == nullptr)
+		{
+			continue;
+		}
+
+		FParallelBehaviorRuntime& rt = RunningTrees[*index];
+		if (rt.bSleeping)
+		{
+			WakeRuntime(rt);
+		}
+
+		UBehaviorTreeComponent* layerTree = rt.TreeComponent.Get();
+		for (const FParallelBehaviorMessageWatcher& watcher : MessageWatchers)
+		{
+			if (layerTree != nullptr && watcher.TreeComponent.Get() == layerTree)
+			{
+				layerTree->RequestBranchEvaluation(*watcher.Decorator);
+			}
+		}
+	}
+	return numRecipients;
+}
+
+bool UParallelBehaviorManagerComponent::HasMessage(FName InLayerId, FGameplayTag InType) const
+{
+	return HasMessageForSlot(GetMessageSlot(InLayerId), InType);
+}
+
+bool UParallelBehaviorManagerComponent::ReceiveMessage(FName InLayerId, FGameplayTag InType, FParallelBehaviorMessage& OutMessage)
+{
+	return ReceiveMessageForSlot(GetMessageSlot(InLayerId), InType, OutMessage);
+}
+
+int32 UParallelBehaviorManagerComponent::GetMessageSlot(const FName& InLayerId) const
+{
+	const int32* index = TreeIndexById.Find(InLayerId);
+	return index != nullptr ? RunningTrees[*index].MessageSlot : INDEX_NONE;
+}
+
+bool UParallelBehaviorManagerComponent::HasMessageForSlot(int32 InSlot, const FGameplayTag& InType) const
+{
+	if (InSlot == INDEX_NONE || PendingMessages[InSlot] == 0)
+	{
+		return false;
+	}
+	if (!InType.IsValid())
+	{
+		return true;
+	}
+
+	const uint64 bit = 1ull << InSlot;
+	for (int32 i = 0; i < MessageCount; ++i)
+	{
+		const int32 ringIndex = (MessageHead + i) % MessageRing.Num();
+		if ((MessageRecipients[ringIndex] & bit) != 0 && MessageRing[ringIndex].Type.MatchesTag(InType))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UParallelBehaviorManagerComponent::ReceiveMessageForSlot(int32 InSlot, const FGameplayTag& InType, FParallelBehaviorMessage& OutMessage)
+{
+	if (InSlot == INDEX_NONE || PendingMessages[InSlot] == 0)
+	{
+		return false;
+	}
+
+	const uint64 bit = 1ull << InSlot;
+	for (int32 i = 0; i < MessageCount; ++i)
+	{
+		const int32 ringIndex = (MessageHead + i) % MessageRing.Num();
+		if ((MessageRecipients[ringIndex] & bit) != 0 && (!InType.IsValid() || MessageRing[ringIndex].Type.MatchesTag(InType)))
+		{
+			OutMessage = MessageRing[ringIndex];
+			MessageRecipients[ringIndex] &= ~bit;
+			--PendingMessages[InSlot];
+			CompactMessages();
+			return true;
+		}
+	}
+	return false;
+}
+
+void UParallelBehaviorManagerComponent::DropOldestMessage()
+{
+	if (MessageCount == 0)
+	{
+		return;
+	}
+
+	for (uint64 bits = MessageRecipients[MessageHead]; bits != 0; bits &= bits - 1)
+	{
+		--PendingMessages[FMath::CountTrailingZeros64(bits)];
+	}
+	MessageRecipients[MessageHead] = 0;
+	CompactMessages();
+}
+
+void UParallelBehaviorManagerComponent::CompactMessages()
+{
+	while (MessageCount > 0 && MessageRecipients[MessageHead] == 0)
+	{
+		// release the object reference of the delivered message
+		MessageRing[MessageHead].ObjectValue = nullptr;
+		MessageHead = (MessageHead + 1) % MessageRing.Num();
+		--MessageCount;
+	}
+}
+
+void UParallelBehaviorManagerComponent::AddMessageWatcher(UBehaviorTreeComponent& InTree, const UBTDecorator& InDecorator)
+{
+	// matched by tree component on post, decorators may become relevant before StartTree returns
+	FParallelBehaviorMessageWatcher& watcher = MessageWatchers.AddDefaulted_GetRef();
+	watcher.TreeComponent = &InTree;
+	watcher.Decorator = &InDecorator;
+}
+
+void UParallelBehaviorManagerComponent::RemoveMessageWatcher(const UBehaviorTreeComponent& InTree, const UBTDecorator& InDecorator)
+{
+	MessageWatchers.RemoveAllSwap([&InTree, &InDecorator](const FParallelBehaviorMessageWatcher& InWatcher)
+	{
+		return InWatcher.Decorator == &InDecorator && InWatcher.TreeComponent.Get() == &InTree;
+	});
+}
+
+bool UParallelBehaviorManagerComponent::SetTreeTickInterval(const FName& InId, float InTickInterval)
+{
+	const int32 index = FindTreeIndex(InId);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FParallelBehaviorRuntime& rt = RunningTrees[index];
+	if (!ApplyTickInterval(rt, InTickInterval))
+	{
+		return false;
+	}
+
+	// stats and snapshots report the interval the layer runs with
+	rt.Setup.TickInterval = FMath::Max(InTickInterval, 0.0f);
+	return true;
+}
+
+bool UParallelBehaviorManagerComponent::ApplyTickInterval(FParallelBehaviorRuntime& InRuntime, float InTickInterval)
+{
+	UBehaviorTreeComponent* btComp = InRuntime.TreeComponent.Get();
+	UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+	if (btComp == nullptr || subsystem == nullptr)
+	{
+		return false;
+	}
+
+	if (!InRuntime.bManagedTick)
+	{
+		// disable the own tick function for good, the tree would otherwise re-enable it whenever it schedules a tick
+		btComp->SetComponentTickEnabled(false);
+		btComp->PrimaryComponentTick.bCanEverTick = false;
+		subsystem->SetLayerManagedTick(InRuntime.LayerHandle, InTickInterval, InRuntime.Setup.Priority, false);
+		InRuntime.bManagedTick = true;
+		return true;
+	}
+
+	return subsystem->SetLayerTickSettings(InRuntime.LayerHandle, InTickInterval, InRuntime.Setup.Priority);
+}
+
+bool UParallelBehaviorManagerComponent::SetTreePriority(const FName& InId, int32 InPriority)
+{
+	const int32 index = FindTreeIndex(InId);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FParallelBehaviorRuntime& rt = RunningTrees[index];
+	rt.Setup.Priority = InPriority;
+
+	UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+	if (!rt.bManagedTick || subsystem == nullptr)
+	{
+		// priority only matters for the managed scheduler
+		return true;
+	}
+
+	return subsystem->SetLayerTickSettings(rt.LayerHandle, subsystem->GetLayerTickInterval(rt.LayerHandle), InPriority);
+}
+
+void UParallelBehaviorManagerComponent::SetPausedByWorld(bool bInPaused)
+{
+	for (FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		if (bInPaused)
+		{
+			AddPauseReason(rt, EParallelBehaviorPauseReason::World);
+		}
+		else
+		{
+			RemovePauseReason(rt, EParallelBehaviorPauseReason::World);
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::NotifyOwnerTagsChanged()
+{
+	ReadOwnerTags(OwnerTags);
+	ApplyOwnerTags();
+}
+
+void UParallelBehaviorManagerComponent::SetOwnerTags(const FGameplayTagContainer& InTags)
+{
+	OwnerTags = InTags;
+	ApplyOwnerTags();
+}
+
+void UParallelBehaviorManagerComponent::HandleOwnerTagChanged(const FGameplayTag InTag, int32 InNewCount)
+{
+	const bool bHadTag = OwnerTags.HasTagExact(InTag);
+	if (bHadTag == (InNewCount > 0))
+	{
+		// stack count changes do not affect the queries
+		return;
+	}
+
+	if (InNewCount > 0)
+	{
+		OwnerTags.AddTagFast(InTag);
+	}
+	else
+	{
+		OwnerTags.RemoveTag(InTag);
+	}
+	ApplyOwnerTags();
+}
+
+bool UParallelBehaviorManagerComponent::IsLayerInactive(FName InId) const
+{
+	return InactiveLayers.ContainsByPredicate([&InId](const FParallelBehaviorSetup& InSetup) { return InSetup.Id == InId; });
+}
+
+bool UParallelBehaviorManagerComponent::IsLayerIdTaken(const FName& InId) const
+{
+	return TreeIndexById.Contains(InId) || ProcessorLayers.Contains(InId) || IsLayerInactive(InId);
+}
+
+bool UParallelBehaviorManagerComponent::HasActivationQueries(const FParallelBehaviorSetup& InSetup)
+{
+	return !InSetup.ActivationQuery.IsEmpty() || !InSetup.DeactivationQuery.IsEmpty();
+}
+
+bool UParallelBehaviorManagerComponent::IsSetupActive(const FParallelBehaviorSetup& InSetup) const
+{
+	return (InSetup.ActivationQuery.IsEmpty() || InSetup.ActivationQuery.Matches(OwnerTags))
+		&& (InSetup.DeactivationQuery.IsEmpty() || !InSetup.DeactivationQuery.Matches(OwnerTags));
+}
+
+bool UParallelBehaviorManagerComponent::ReadOwnerTags(FGameplayTagContainer& OutTags) const
+{
+	const IGameplayTagAssetInterface* tagSource = Cast<IGameplayTagAssetInterface>(GetOwner());
+	if (tagSource == nullptr)
+	{
+		tagSource = Cast<IGameplayTagAssetInterface>(GetPawn());
+	}
+	if (tagSource == nullptr)
+	{
+		return false;
+	}
+
+	OutTags.Reset();
+	tagSource->GetOwnedGameplayTags(OutTags);
+	return true;
+}
+
+void UParallelBehaviorManagerComponent::ApplyOwnerTags()
+{
+	// start layers that became active first, layers released below are inactive and skipped here
+	for (int32 i = 0; i < InactiveLayers.Num();)
+	{
+		if (!IsSetupActive(InactiveLayers[i]))
+		{
+			++i;
+			continue;
+		}
+
+		const FParallelBehaviorSetup setup = MoveTemp(InactiveLayers[i]);
+		InactiveLayers.RemoveAt(i, 1, EAllowShrinking::No);
+		AddTreeInternal(setup, nullptr);
+	}
+
+	// backwards, RemoveTree moves the last runtime into the freed index
+	for (int32 i = RunningTrees.Num() - 1; i >= 0; --i)
+	{
+		FParallelBehaviorRuntime& rt = RunningTrees[i];
+		if (!HasActivationQueries(rt.Setup))
+		{
+			continue;
+		}
+
+		if (IsSetupActive(rt.Setup))
+		{
+			RemovePauseReason(rt, EParallelBehaviorPauseReason::Tags);
+		}
+		else if (rt.Setup.bReleaseWhenInactive)
+		{
+			const FName id = rt.Setup.Id;
+			InactiveLayers.Add(rt.Setup);
+			RemoveTree(id);
+		}
+		else
+		{
+			AddPauseReason(rt, EParallelBehaviorPauseReason::Tags);
+		}
+	}
+
+	TArray<FName, TInlineAllocator<4>> releasedProcessorLayers;
+	for (const TPair<FName, FParallelBehaviorSetup>& gatedLayer : GatedProcessorSetups)
+	{
+		if (!IsSetupActive(gatedLayer.Value))
+		{
+			releasedProcessorLayers.Add(gatedLayer.Key);
+			InactiveLayers.Add(gatedLayer.Value);
+		}
+	}
+	for (const FName& id : releasedProcessorLayers)
+	{
+		RemoveTree(id);
+	}
+}
+
+UParallelBehaviorSubsystem* UParallelBehaviorManagerComponent::GetParallelBehaviorSubsystem() const
+{
+	const UWorld* world = GetWorld();
+	return world != nullptr ? world->GetSubsystem<UParallelBehaviorSubsystem>() : nullptr;
+}
+
+void UParallelBehaviorManagerComponent::SetLOD(int32 InLOD)
+{
+	InLOD = FMath::Max(InLOD, 0);
+	if (InLOD == CurrentLOD)
+	{
+		return;
+	}
+
+	CurrentLOD = InLOD;
+	for (FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		ApplyLOD(rt);
+	}
+}
+
+int32 UParallelBehaviorManagerComponent::GetLODForDistance(float InDistance) const
+{
+	int32 lod = 0;
+	while (lod < LODDistances.Num() && InDistance >= LODDistances[lod])
+	{
+		++lod;
+	}
+	return lod;
+}
+
+void UParallelBehaviorManagerComponent::ApplyLOD(FParallelBehaviorRuntime& InRuntime)
+{
+	const FParallelBehaviorSetup& setup = InRuntime.Setup;
+	if (setup.MaxLOD >= 0 && CurrentLOD > setup.MaxLOD)
+	{
+		AddPauseReason(InRuntime, EParallelBehaviorPauseReason::LOD);
+		return;
+	}
+
+	RemovePauseReason(InRuntime, EParallelBehaviorPauseReason::LOD);
+	if (setup.LODTickIntervals.Num() > 0)
+	{
+		const float interval = setup.LODTickIntervals[FMath::Min(CurrentLOD, setup.LODTickIntervals.Num() - 1)];
+		SetTreeTickInterval(setup.Id, interval);
+	}
+}
+
+void UParallelBehaviorManagerComponent::AddPauseReason(FParallelBehaviorRuntime& InRuntime, EParallelBehaviorPauseReason InReason)
+{
+	const bool bWasRunning = InRuntime.PauseReasons == EParallelBehaviorPauseReason::None;
+	InRuntime.PauseReasons |= InReason;
+
+	UBehaviorTreeComponent* btComp = InRuntime.TreeComponent.Get();
+	if (!bWasRunning || btComp == nullptr)
+	{
+		return;
+	}
+
+	// pausing keeps the active node and the blackboard, ResumeLogic picks up where it left off
+	btComp->PauseLogic(TEXT("ParallelBehavior"));
+	if (!InRuntime.bManagedTick)
+	{
+		// a paused tree costs nothing, ResumeLogic schedules the next tick again
+		btComp->SetComponentTickEnabled(false);
+	}
+	if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+	{
+		subsystem->SetLayerPaused(InRuntime.LayerHandle, true);
+	}
+}
+
+void UParallelBehaviorManagerComponent::RemovePauseReason(FParallelBehaviorRuntime& InRuntime, EParallelBehaviorPauseReason InReason)
+{
+	if (!EnumHasAnyFlags(InRuntime.PauseReasons, InReason))
+	{
+		return;
+	}
+
+	InRuntime.PauseReasons &= ~InReason;
+
+	UBehaviorTreeComponent* btComp = InRuntime.TreeComponent.Get();
+	if (InRuntime.PauseReasons != EParallelBehaviorPauseReason::None || btComp == nullptr)
+	{
+		return;
+	}
+
+	if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+	{
+		subsystem->SetLayerPaused(InRuntime.LayerHandle, false);
+	}
+	btComp->ResumeLogic(TEXT("ParallelBehavior"));
+}
+
+void UParallelBehaviorManagerComponent::InitializeSharedBlackboard()
+{
+	if (SharedBlackboardAsset == nullptr || SharedBlackboard != nullptr)
+	{
+		return;
+	}
+
+	SharedBlackboard = NewObject<UBlackboardComponent>(this,
+		MakeUniqueObjectName(this, UBlackboardComponent::StaticClass(), TEXT("Shared_BlackboardComponent")));
+	if (!SharedBlackboard->InitializeBlackboard(*SharedBlackboardAsset))
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("InitializeSharedBlackboard: Failed to initialize '%s'"), *GetNameSafe(SharedBlackboardAsset));
+	}
+	SharedBlackboard->RegisterComponent();
+
+	const FBlackboard::FKey selfKey = FParallelBehaviorAssetCache::Get().GetLayout(*SharedBlackboardAsset).SelfKey;
+	if (selfKey != FBlackboard::InvalidKey)
+	{
+		SharedBlackboard->SetValue<UBlackboardKeyType_Object>(selfKey, GetPawn());
+	}
+
+	const int32 numKeys = SharedBlackboardAsset->GetNumKeys();
+	for (int32 i = 0; i < numKeys; ++i)
+	{
+		const FBlackboard::FKey key = static_cast<FBlackboard::FKey>(i);
+		if (SharedKeys.Num() == 0 || SharedKeys.Contains(SharedBlackboardAsset->GetKeyName(key)))
+		{
+			SharedBlackboard->RegisterObserver(key, this,
+				FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnSharedKeyChanged));
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::ReleaseSharedBlackboard()
+{
+	if (SharedBlackboard != nullptr)
+	{
+		SharedBlackboard->UnregisterObserversFrom(this);
+		SharedBlackboard->DestroyComponent();
+		SharedBlackboard = nullptr;
+	}
+	SharedKeyRoutes.Empty();
+}
+
+const TArray<FBlackboard::FKey>& UParallelBehaviorManagerComponent::GetKeyRoutes(
+	TMap<TObjectKey<UBlackboardData>, TArray<FBlackboard::FKey>>& InOutRoutes, const UBlackboardData& InSourceAsset,
+	const TArray<FName>& InKeyFilter, const UBlackboardData& InLayerAsset)
+{
+	if (const TArray<FBlackboard::FKey>* routes = InOutRoutes.Find(&InLayerAsset))
+	{
+		return *routes;
+	}
+
+	TArray<FBlackboard::FKey>& routes = InOutRoutes.Add(&InLayerAsset);
+	FParallelBehaviorBlackboardUtils::BuildKeyRoutes(InSourceAsset, InLayerAsset, InKeyFilter, routes);
+	return routes;
+}
+
+void UParallelBehaviorManagerComponent::CopyRoutedValues(const UBlackboardComponent& InSource, TConstArrayView<FBlackboard::FKey> InRoutes,
+	UBlackboardComponent& InLayerBlackboard)
+{
+	for (int32 i = 0; i < InRoutes.Num(); ++i)
+	{
+		if (InRoutes[i] != FBlackboard::InvalidKey)
+		{
+			FParallelBehaviorBlackboardUtils::CopyValue(InSource, static_cast<FBlackboard::FKey>(i), InLayerBlackboard, InRoutes[i]);
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::MirrorKey(const UBlackboardComponent& InSource, FBlackboard::FKey InKey,
+	TMap<TObjectKey<UBlackboardData>, TArray<FBlackboard::FKey>>& InOutRoutes, const TArray<FName>& InKeyFilter)
+{
+	const UBlackboardData* sourceAsset = InSource.GetBlackboardAsset();
+	if (sourceAsset == nullptr)
+	{
+		return;
+	}
+
+	for (const FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		UBlackboardComponent* layerBlackboard = rt.BlackboardComponent.Get();
+		const UBlackboardData* layerAsset = layerBlackboard != nullptr ? layerBlackboard->GetBlackboardAsset() : nullptr;
+		if (layerAsset == nullptr)
+		{
+			continue;
+		}
+
+		const TArray<FBlackboard::FKey>& routes = GetKeyRoutes(InOutRoutes, *sourceAsset, InKeyFilter, *layerAsset);
+		if (routes.IsValidIndex(InKey) && routes[InKey] != FBlackboard::InvalidKey)
+		{
+			FParallelBehaviorBlackboardUtils::CopyValue(InSource, InKey, *layerBlackboard, routes[InKey]);
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::SyncSharedValues(UBlackboardComponent& InLayerBlackboard)
+{
+	const UBlackboardData* layerAsset = InLayerBlackboard.GetBlackboardAsset();
+	if (layerAsset == nullptr)
+	{
+		return;
+	}
+
+	if (SharedBlackboard != nullptr)
+	{
+		CopyRoutedValues(*SharedBlackboard, GetKeyRoutes(SharedKeyRoutes, *SharedBlackboardAsset, SharedKeys, *layerAsset),
+			InLayerBlackboard);
+	}
+
+	// squad values win over manager shared values for keys both provide
+	const UBlackboardComponent* squadBlackboard = Squad != nullptr ? Squad->GetBlackboard() : nullptr;
+	const UBlackboardData* squadAsset = squadBlackboard != nullptr ? squadBlackboard->GetBlackboardAsset() : nullptr;
+	if (squadAsset != nullptr)
+	{
+		CopyRoutedValues(*squadBlackboard, GetKeyRoutes(SquadKeyRoutes, *squadAsset, SquadKeys, *layerAsset), InLayerBlackboard);
+	}
+}
+
+EBlackboardNotificationResult UParallelBehaviorManagerComponent::OnSharedKeyChanged(const UBlackboardComponent& InBlackboard,
+	FBlackboard::FKey InKey)
+{
+	MirrorKey(InBlackboard, InKey, SharedKeyRoutes, SharedKeys);
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
+void UParallelBehaviorManagerComponent::JoinSquad(UParallelBehaviorSquad* InSquad)
+{
+	if (InSquad == Squad)
+	{
+		return;
+	}
+
+	LeaveSquad();
+	const UBlackboardComponent* squadBlackboard = InSquad != nullptr ? InSquad->GetBlackboard() : nullptr;
+	const UBlackboardData* squadAsset = squadBlackboard != nullptr ? squadBlackboard->GetBlackboardAsset() : nullptr;
+	if (squadAsset == nullptr)
+	{
+		return;
+	}
+
+	Squad = InSquad;
+	Squad->AddMember(this);
+
+	for (const FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		UBlackboardComponent* layerBlackboard = rt.BlackboardComponent.Get();
+		const UBlackboardData* layerAsset = layerBlackboard != nullptr ? layerBlackboard->GetBlackboardAsset() : nullptr;
+		if (layerAsset != nullptr)
+		{
+			CopyRoutedValues(*squadBlackboard, GetKeyRoutes(SquadKeyRoutes, *squadAsset, SquadKeys, *layerAsset), *layerBlackboard);
+		}
+	}
+}
+
+void UParallelBehaviorManagerComponent::LeaveSquad()
+{
+	if (Squad != nullptr)
+	{
+		Squad->RemoveMember(this);
+		Squad = nullptr;
+	}
+	SquadKeyRoutes.Empty();
+}
+
+void UParallelBehaviorManagerComponent::MirrorSquadKey(const UBlackboardComponent& InSquadBlackboard, FBlackboard::FKey InKey)
+{
+	MirrorKey(InSquadBlackboard, InKey, SquadKeyRoutes, SquadKeys);
+}
+
+int32 UParallelBehaviorManagerComponent::SetValuesOnTrees(const TArray<FParallelBehaviorBlackboardValue>& InValues,
+	const TArray<FName>& InTreeIds)
+{
+	if (InValues.Num() == 0)
+	{
+		return 0;
+	}
+
+	int32 written = 0;
+	if (InTreeIds.Num() == 0)
+	{
+		for (const FParallelBehaviorRuntime& rt : RunningTrees)
+		{
+			if (UBlackboardComponent* blackboard = rt.BlackboardComponent.Get())
+			{
+				const bool bHoldNotifications = rt.PauseReasons == EParallelBehaviorPauseReason::None;
+				written += ApplyValuesBatched(*blackboard, InValues, bHoldNotifications) > 0 ? 1 : 0;
+			}
+		}
+		return written;
+	}
+
+	for (const FName& id : InTreeIds)
+	{
+		const int32 index = FindTreeIndex(id);
+		if (index == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FParallelBehaviorRuntime& rt = RunningTrees[index];
+		if (UBlackboardComponent* blackboard = rt.BlackboardComponent.Get())
+		{
+			const bool bHoldNotifications = rt.PauseReasons == EParallelBehaviorPauseReason::None;
+			written += ApplyValuesBatched(*blackboard, InValues, bHoldNotifications) > 0 ? 1 : 0;
+		}
+	}
+	return written;
+}
+
+int32 UParallelBehaviorManagerComponent::ApplyValuesBatched(UBlackboardComponent& InBlackboard,
+	TConstArrayView<FParallelBehaviorBlackboardValue> InValues, bool bInHoldNotifications)
+{
+	const UBlackboardData* blackboardAsset = InBlackboard.GetBlackboardAsset();
+	if (blackboardAsset == nullptr)
+	{
+		return 0;
+	}
 
-void UParallelBehaviorManagerComponent::RunDefaultTrees()
+	const FParallelBehaviorBlackboardLayout& layout = FParallelBehaviorAssetCache::Get().GetLayout(*blackboardAsset);
+
+	// hold notifications so observers (decorator aborts) fire once per key after the whole batch is written
+	if (bInHoldNotifications)
+	{
+		InBlackboard.PauseObserverNotifications();
+	}
+	int32 written = 0;
+	for (const FParallelBehaviorBlackboardValue& value : InValues)
+	{
+		if (value.ApplyTo(InBlackboard, layout.Find(value.Key)))
+		{
+			++written;
+		}
+	}
+	if (bInHoldNotifications)
+	{
+		InBlackboard.ResumeObserverNotifications(true);
+	}
+	return written;
+}
+
+bool UParallelBehaviorManagerComponent::RemoveTree(FName Id, EParallelBehaviorStopMode StopMode)
 {
-	int32 n = ParallelBehaviorDefaults.Num();
-	for (int32 i = 0; i < n; ++i)
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_RemoveTree);
+
+	FParallelBehaviorProcessorHandle processorHandle;
+	if (ProcessorLayers.RemoveAndCopyValue(Id, processorHandle))
+	{
+		GatedProcessorSetups.Remove(Id);
+		if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
+		{
+			subsystem->RemoveProcessorLayer(processorHandle);
+		}
+		return true;
+	}
+
+	const int32 foundIndex = FindTreeIndex(Id);
+	if (foundIndex == INDEX_NONE)
 	{
-		AddTree(ParallelBehaviorDefaults[i]);
+		return InactiveLayers.RemoveAll([&Id](const FParallelBehaviorSetup& InSetup) { return InSetup.Id == Id; }) > 0;
 	}
+
+	ReleasePair(RunningTrees[foundIndex], StopMode);
+	RemoveRuntimeAtSwap(foundIndex);
+	UE_LOG(LogParallelBehavior, Verbose, TEXT("RemoveTree: Removed tree '%s'"), *Id.ToString());
+	return true;
 }
 
+void UParallelBehaviorManagerComponent::RemoveRuntimeAtSwap(int32 InIndex)
+{
+	const int32 lastIndex = RunningTrees.Num() - 1;
+	TreeIndexById.Remove(RunningTrees[InIndex].Id);
+	if (InIndex != lastIndex)
+	{
+		// last entry is moved into the freed slot, keep its index in sync
+		TreeIndexById.Add(RunningTrees[lastIndex].Id, InIndex);
+	}
+	RunningTrees.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+}
 
-// Called when the game starts
-void UParallelBehaviorManagerComponent::BeginPlay()
+void UParallelBehaviorManagerComponent::RemoveAllTrees(EParallelBehaviorStopMode StopMode)
 {
-	Super::BeginPlay();
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_RemoveTree);
 
-	if (GetOwner()->HasAuthority())
+	for (int32 i = RunningTrees.Num() - 1; i >= 0; --i)
 	{
-		RunDefaultTrees();
+		ReleasePair(RunningTrees[i], StopMode);
 	}
+	RunningTrees.Empty();
+	TreeIndexById.Empty();
+	InactiveLayers.Empty();
+	RemoveAllProcessorLayers();
 }
 
-void UParallelBehaviorManagerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+void UParallelBehaviorManagerComponent::TeardownTrees()
 {
-	RemoveAllTrees(); // Ensures proper cleanup
-	Super::EndPlay(EndPlayReason);
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_RemoveTree);
+
+	const UWorld* world = GetWorld();
+	const AActor* owner = GetOwner();
+	const bool bWorldEnding = world == nullptr || world->bIsTearingDown;
+	const bool bOwnerEnding = bWorldEnding || owner == nullptr || owner->IsActorBeingDestroyed();
+	UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+
+	for (int32 i = RunningTrees.Num() - 1; i >= 0; --i)
+	{
+		FParallelBehaviorRuntime& rt = RunningTrees[i];
+		if (!bOwnerEnding)
+		{
+			ReleasePair(rt, EParallelBehaviorStopMode::Forced, true);
+			continue;
+		}
+
+		// the owner destroys the pair, only its execution and the world side bookkeeping are ended here
+		if (UBehaviorTreeComponent* btComp = rt.TreeComponent.Get(); btComp != nullptr && !bWorldEnding)
+		{
+			btComp->StopTree(EBTStopMode::Forced);
+		}
+		if (subsystem != nullptr)
+		{
+			subsystem->UnregisterLayer(rt.LayerHandle);
+		}
+		ReleaseMessageSlot(rt);
+	}
+	RunningTrees.Reset();
+	TreeIndexById.Reset();
+	InactiveLayers.Reset();
+	RemoveAllProcessorLayers();
 }
 
-bool UParallelBehaviorManagerComponent::AddTree(const FParallelBehaviorSetup& InSetup)
+void UParallelBehaviorManagerComponent::RemoveAllProcessorLayers()
 {
-	if (InSetup.BTAsset == nullptr)
+	if (UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
 	{
-		UE_LOG(LogParallelBehavior, Warning, TEXT("AddTree: Unable to run NULL behavior tree"));
-		return false;
+		for (TPair<FName, FParallelBehaviorProcessorHandle>& layer : ProcessorLayers)
+		{
+			subsystem->RemoveProcessorLayer(layer.Value);
+		}
 	}
+	ProcessorLayers.Empty();
+	GatedProcessorSetups.Empty();
+}
 
-	UBlackboardComponent* blackboardComp = nullptr;
-	if (InSetup.BTAsset->BlackboardAsset == nullptr)
+TArray<FParallelBehaviorLayerStats> UParallelBehaviorManagerComponent::GetLayerStats() const
+{
+	const UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+
+	TArray<FParallelBehaviorLayerStats> result;
+	result.Reserve(RunningTrees.Num());
+	for (const FParallelBehaviorRuntime& rt : RunningTrees)
 	{
-		UE_LOG(LogParallelBehavior, Warning, TEXT("AddTree: trying to use NULL Blackboard asset. Ignoring"));
+		FParallelBehaviorLayerStats& stats = result.AddDefaulted_GetRef();
+		stats.Id = rt.Id;
+		stats.bManagedTick = rt.bManagedTick;
+		stats.bPaused = rt.PauseReasons != EParallelBehaviorPauseReason::None;
+		stats.TickInterval = rt.Setup.TickInterval;
+		stats.Priority = rt.Setup.Priority;
+		if (subsystem != nullptr)
+		{
+			subsystem->GetLayerStats(rt.LayerHandle, stats);
+		}
 	}
-	else
+	return result;
+}
+
+FParallelBehaviorMemoryStats& FParallelBehaviorMemoryStats::operator+=(const FParallelBehaviorMemoryStats& InOther)
+{
+	NumLayers += InOther.NumLayers;
+	NumBlackboards += InOther.NumBlackboards;
+	NumPooledPairs += InOther.NumPooledPairs;
+	RuntimeBytes += InOther.RuntimeBytes;
+	BlackboardValueBytes += InOther.BlackboardValueBytes;
+	TreeInstanceBytes += InOther.TreeInstanceBytes;
+	ComponentBytes += InOther.ComponentBytes;
+	PoolBytes += InOther.PoolBytes;
+	MessageBytes += InOther.MessageBytes;
+	RegistryBytes += InOther.RegistryBytes;
+	return *this;
+}
+
+FParallelBehaviorMemoryStats UParallelBehaviorManagerComponent::GetMemoryStats() const
+{
+	FParallelBehaviorMemoryStats stats;
+	stats.NumLayers = RunningTrees.Num() + ProcessorLayers.Num();
+	stats.NumPooledPairs = ComponentPool.Num();
+	stats.RuntimeBytes = RunningTrees.GetAllocatedSize() + TreeIndexById.GetAllocatedSize() + ProcessorLayers.GetAllocatedSize();
+
+	FParallelBehaviorAssetCache& assetCache = FParallelBehaviorAssetCache::Get();
+	UBehaviorTreeManager* treeManager = UBehaviorTreeManager::GetCurrent(GetWorld());
+	for (const FParallelBehaviorRuntime& rt : RunningTrees)
 	{
-		const FString bbName = FString::Printf(TEXT("%s_BlackboardComponent"), *InSetup.Id.ToString());
+		const FParallelBehaviorSetup& setup = rt.Setup;
+		stats.RuntimeBytes += setup.InitialValues.GetAllocatedSize() + setup.LODTickIntervals.GetAllocatedSize()
+			+ setup.WakeKeys.GetAllocatedSize() + setup.WakeTags.GetGameplayTagArray().GetAllocatedSize()
+			+ setup.MessageTags.GetGameplayTagArray().GetAllocatedSize();
 
-		blackboardComp = NewObject<UBlackboardComponent>(this, *bbName);
-		if (blackboardComp != nullptr)
+		if (const UBehaviorTreeComponent* btComp = rt.TreeComponent.Get())
+		{
+			stats.ComponentBytes += btComp->GetClass()->GetStructureSize();
+		}
+		if (const UBlackboardComponent* blackboard = rt.BlackboardComponent.Get())
 		{
-			if (blackboardComp->InitializeBlackboard(*InSetup.BTAsset->BlackboardAsset))
+			++stats.NumBlackboards;
+			stats.ComponentBytes += blackboard->GetClass()->GetStructureSize();
+			if (const UBlackboardData* blackboardAsset = blackboard->GetBlackboardAsset())
 			{
-				// find the "self" key and set it to our pawn
-				const FBlackboard::FKey selfKey = InSetup.BTAsset->BlackboardAsset->GetKeyID(FBlackboard::KeySelf);
-				if (selfKey != FBlackboard::InvalidKey)
-				{
-					blackboardComp->SetValue<UBlackboardKeyType_Object>(selfKey, GetPawn());
-				}
+				stats.BlackboardValueBytes += assetCache.GetLayout(*blackboardAsset).ValueMemorySize;
 			}
-			blackboardComp->RegisterComponent();
+		}
 
+		UBehaviorTree* btAsset = rt.BTAsset.Get();
+		UBTCompositeNode* root = nullptr;
+		uint16 instanceMemorySize = 0;
+		if (treeManager != nullptr && btAsset != nullptr && treeManager->LoadTree(*btAsset, root, instanceMemorySize))
+		{
+			stats.TreeInstanceBytes += instanceMemorySize;
 		}
 	}
-	const FString btName = FString::Printf(TEXT("%s_BehaviorTreeComponent"), *InSetup.Id.ToString());
-	UBehaviorTreeComponent* btComp = NewObject<UBehaviorTreeComponent>(this, *btName);
-	btComp->RegisterComponent();
 
-	check(btComp != nullptr);
-	btComp->StartTree(*InSetup.BTAsset, EBTExecutionMode::Looped);
+	stats.PoolBytes = ComponentPool.GetAllocatedSize();
+	for (const FParallelBehaviorPooledPair& pair : ComponentPool)
+	{
+		if (pair.TreeComponent != nullptr)
+		{
+			stats.PoolBytes += pair.TreeComponent->GetClass()->GetStructureSize();
+		}
+		if (pair.BlackboardComponent != nullptr)
+		{
+			stats.PoolBytes += pair.BlackboardComponent->GetClass()->GetStructureSize();
+		}
+		if (pair.BlackboardAsset != nullptr)
+		{
+			stats.PoolBytes += assetCache.GetLayout(*pair.BlackboardAsset).ValueMemorySize;
+		}
+	}
 
-	RunningTrees.Add(
-		FParallelBehaviorRuntime(InSetup.Id, btComp, blackboardComp));
+	stats.MessageBytes = MessageRing.GetAllocatedSize() + MessageRecipients.GetAllocatedSize()
+		+ MessageSubscribers.GetAllocatedSize() + MessageWatchers.GetAllocatedSize();
+	return stats;
+}
 
-	UE_LOG(LogParallelBehavior, Log, TEXT("AddTree: Started tree '%s' with blackboard '%s'"), *GetNameSafe(InSetup.BTAsset.Get()),
-		*GetNameSafe(InSetup.BTAsset->BlackboardAsset));
-	return true;
+APawn* UParallelBehaviorManagerComponent::GetPawn_Implementation() const
+{
+	if (AController* ownerController = GetOwner<AController>())
+	{
+		return ownerController->GetPawn();
+	}
+	return nullptr;
 }
 
-void UParallelBehaviorManagerComponent::StopTree(const FName& InId)
+UBehaviorTreeComponent* UParallelBehaviorManagerComponent::GetTree(const FName& InId) const
 {
-	if (UBehaviorTreeComponent* tree = GetTree(InId))
+	UBehaviorTreeComponent* tree = FindTree(InId);
+	if (tree == nullptr)
 	{
-		tree->StopTree();
+		UE_LOG(LogParallelBehavior, Verbose, TEXT("[UParallelBehaviorManagerComponent] Failed to find behavior tree with id '%s'"), *InId.ToString());
 	}
+	return tree;
 }
 
-void UParallelBehaviorManagerComponent::RestartTree(const FName& InId)
+bool UParallelBehaviorManagerComponent::AddProcessorLayer(const FParallelBehaviorSetup& InSetup)
 {
-	if (UBehaviorTreeComponent* tree = GetTree(InId))
+	UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+	if (subsystem == nullptr)
 	{
-		tree->RestartTree();
+		UE_LOG(LogParallelBehavior, Warning, TEXT("AddProcessorLayer: Processor layers need a game world"));
+		return false;
+	}
+
+	const FName layerId = InSetup.Id.IsNone() ? FName(InSetup.Processor->GetFName(), ++GeneratedIdCounter) : InSetup.Id;
+	if (IsLayerIdTaken(layerId))
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("AddProcessorLayer: Layer with id '%s' is already running"), *layerId.ToString());
+		return false;
+	}
+
+	const FParallelBehaviorProcessorHandle handle = subsystem->AddProcessorLayer(this, layerId, InSetup.Processor, InSetup.InitialFragment);
+	if (!handle.IsValid())
+	{
+		return false;
+	}
+
+	ProcessorLayers.Add(layerId, handle);
+	if (HasActivationQueries(InSetup))
+	{
+		FParallelBehaviorSetup& gatedSetup = GatedProcessorSetups.Add(layerId, InSetup);
+		gatedSetup.Id = layerId;
+	}
+	if (bAllPaused)
+	{
+		subsystem->SetProcessorLayerPaused(handle, true);
 	}
+
+	UE_LOG(LogParallelBehavior, Verbose, TEXT("AddProcessorLayer: Started '%s' with processor '%s'"), *layerId.ToString(),
+		*InSetup.Processor->GetName());
+	return true;
 }
 
-bool UParallelBehaviorManagerComponent::RemoveTree(FName Id)
+FParallelBehaviorSnapshot UParallelBehaviorManagerComponent::CaptureSnapshot() const
 {
-	int32 foundIndex = INDEX_NONE;
-	for (int32 i = RunningTrees.Num() - 1; i >= 0; --i)
+	FParallelBehaviorSnapshot snapshot;
+	snapshot.Layers.Reserve(RunningTrees.Num() + ProcessorLayers.Num());
+
+	FParallelBehaviorAssetCache& assetCache = FParallelBehaviorAssetCache::Get();
+	for (const FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		FParallelBehaviorLayerSnapshot& layer = snapshot.Layers.AddDefaulted_GetRef();
+		layer.Setup = rt.Setup;
+		layer.bPaused = EnumHasAnyFlags(rt.PauseReasons, EParallelBehaviorPauseReason::User);
+		layer.bSleeping = rt.bSleeping;
+
+		const UBlackboardComponent* blackboard = rt.BlackboardComponent.Get();
+		const UBlackboardData* blackboardAsset = blackboard != nullptr ? blackboard->GetBlackboardAsset() : nullptr;
+		if (blackboardAsset == nullptr)
+		{
+			continue;
+		}
+
+		const FParallelBehaviorBlackboardLayout& layout = assetCache.GetLayout(*blackboardAsset);
+		layer.BlackboardAsset = const_cast<UBlackboardData*>(blackboardAsset);
+		layer.Values.SetNumUninitialized(layout.SnapshotSize);
+
+		uint8* cursor = layer.Values.GetData();
+		for (int32 i = 0; i < layout.SnapshotKeys.Num(); ++i)
+		{
+			const uint8* raw = blackboard->GetKeyRawData(layout.SnapshotKeys[i]);
+			check(raw != nullptr);
+			FMemory::Memcpy(cursor, raw, layout.SnapshotKeySizes[i]);
+			cursor += layout.SnapshotKeySizes[i];
+		}
+
+		layer.StringValues.Reserve(layout.StringKeys.Num());
+		for (const FBlackboard::FKey key : layout.StringKeys)
+		{
+			layer.StringValues.Add(blackboard->GetValue<UBlackboardKeyType_String>(key));
+		}
+	}
+
+	if (const UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem())
 	{
-		const FParallelBehaviorRuntime& rt = RunningTrees[i];
-		if (rt.Id == Id)
+		for (const TPair<FName, FParallelBehaviorProcessorHandle>& processorLayer : ProcessorLayers)
 		{
-			if (rt.TreeComponent.IsValid())
+			const FParallelBehaviorProcessorBatch* batch = subsystem->GetProcessorBatch(processorLayer.Value);
+			const int32 index = batch != nullptr ? batch->IndexOf(processorLayer.Value) : INDEX_NONE;
+			if (index == INDEX_NONE)
 			{
-				rt.TreeComponent->StopTree(EBTStopMode::Safe); // or Force if you prefer
-				rt.TreeComponent->DestroyComponent();
+				continue;
 			}
-			if (rt.BlackboardComponent.IsValid())
+
+			FParallelBehaviorLayerSnapshot& layer = snapshot.Layers.AddDefaulted_GetRef();
+			if (const FParallelBehaviorSetup* gatedSetup = GatedProcessorSetups.Find(processorLayer.Key))
 			{
-				rt.BlackboardComponent->DestroyComponent();
+				layer.Setup = *gatedSetup;
 			}
-			foundIndex = i;
+			layer.Setup.Id = processorLayer.Key;
+			layer.Setup.Processor = batch->Processor->GetClass();
+			layer.Setup.InitialFragment.InitializeAs(batch->FragmentType, batch->Fragments.GetData() + index * batch->Stride);
+			layer.bPaused = batch->Paused[index];
+		}
+	}
+
+	// inactive layers have no state, restoring them re-evaluates their queries
+	for (const FParallelBehaviorSetup& inactiveSetup : InactiveLayers)
+	{
+		snapshot.Layers.AddDefaulted_GetRef().Setup = inactiveSetup;
+	}
+	return snapshot;
+}
+
+int32 UParallelBehaviorManagerComponent::RestoreSnapshot(const FParallelBehaviorSnapshot& InSnapshot)
+{
+	int32 restored = 0;
+	for (const FParallelBehaviorLayerSnapshot& layer : InSnapshot.Layers)
+	{
+		// layers already running keep their current state
+		if (IsLayerIdTaken(layer.Setup.Id))
+		{
+			continue;
+		}
+		if (!AddTreeInternal(layer.Setup, &layer))
+		{
+			continue;
+		}
 
+		++restored;
+		if (layer.bPaused)
+		{
+			PauseTree(layer.Setup.Id);
+		}
+		if (layer.bSleeping)
+		{
+			SleepTree(layer.Setup.Id);
 		}
 	}
-	if (foundIndex != INDEX_NONE)
+
+	UE_LOG(LogParallelBehavior, Verbose, TEXT("RestoreSnapshot: Restored %d of %d layers on '%s'"), restored, InSnapshot.Layers.Num(),
+		*GetNameSafe(GetOwner()));
+	return restored;
+}
+
+void UParallelBehaviorManagerComponent::RestoreBlackboardValues(UBlackboardComponent& InBlackboard,
+	const FParallelBehaviorBlackboardLayout& InLayout, const FParallelBehaviorLayerSnapshot& InSnapshot)
+{
+	if (InSnapshot.Values.Num() != InLayout.SnapshotSize || InSnapshot.StringValues.Num() != InLayout.StringKeys.Num())
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("RestoreBlackboardValues: Snapshot of '%s' does not match blackboard '%s' anymore"),
+			*InSnapshot.Setup.Id.ToString(), *GetNameSafe(InSnapshot.BlackboardAsset));
+		return;
+	}
+
+	// the tree has not started yet, nobody observes these keys
+	const uint8* cursor = InSnapshot.Values.GetData();
+	for (int32 i = 0; i < InLayout.SnapshotKeys.Num(); ++i)
 	{
-		RunningTrees.RemoveAt(foundIndex);
-		UE_LOG(LogParallelBehavior, Log, TEXT("ParallelBehavior: Removed tree ID '%s'"), *Id.ToString());
+		if (uint8* raw = InBlackboard.GetKeyRawData(InLayout.SnapshotKeys[i]))
+		{
+			FMemory::Memcpy(raw, cursor, InLayout.SnapshotKeySizes[i]);
+		}
+		cursor += InLayout.SnapshotKeySizes[i];
 	}
 
-	return foundIndex != INDEX_NONE;
+	for (int32 i = 0; i < InLayout.StringKeys.Num(); ++i)
+	{
+		InBlackboard.SetValue<UBlackboardKeyType_String>(InLayout.StringKeys[i], InSnapshot.StringValues[i]);
+	}
 }
 
-void UParallelBehaviorManagerComponent::RemoveAllTrees()
+EParallelBehaviorLayerState UParallelBehaviorManagerComponent::GetLayerState(FName InId) const
 {
-	for (int32 i = RunningTrees.Num() - 1; i >= 0; --i)
+	if (const FParallelBehaviorProcessorHandle* handle = ProcessorLayers.Find(InId))
+	{
+		const UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+		return subsystem != nullptr && subsystem->IsProcessorLayerPaused(*handle)
+			? EParallelBehaviorLayerState::Paused
+			: EParallelBehaviorLayerState::Running;
+	}
+
+	const int32 index = FindTreeIndex(InId);
+	if (index == INDEX_NONE)
 	{
-		const FParallelBehaviorRuntime& rt = RunningTrees[i];
+		return EParallelBehaviorLayerState::Inactive;
+	}
+
+	const FParallelBehaviorRuntime& rt = RunningTrees[index];
+	if (rt.bSleeping)
+	{
+		return EParallelBehaviorLayerState::Sleeping;
+	}
+	return rt.PauseReasons != EParallelBehaviorPauseReason::None ? EParallelBehaviorLayerState::Paused : EParallelBehaviorLayerState::Running;
+}
+
+EParallelBehaviorLayerState UParallelBehaviorManagerComponent::GetReplicatedLayerState(FName InId) const
+{
+	const FParallelBehaviorLayerSummaryItem* item = LayerSummary.Find(InId);
+	return item != nullptr ? item->State : EParallelBehaviorLayerState::Inactive;
+}
 
-		if (rt.TreeComponent.IsValid())
+void UParallelBehaviorManagerComponent::UpdateLayerSummary()
+{
+	TArray<FParallelBehaviorLayerSummaryItem>& items = LayerSummary.Items;
+
+	bool bRemoved = false;
+	for (int32 i = items.Num() - 1; i >= 0; --i)
+	{
+		FParallelBehaviorLayerSummaryItem& item = items[i];
+		const EParallelBehaviorLayerState state = GetLayerState(item.Id);
+		if (state == EParallelBehaviorLayerState::Inactive)
 		{
-			rt.TreeComponent->StopTree(EBTStopMode::Safe); // or Force if you prefer
-			rt.TreeComponent->DestroyComponent();
+			items.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			bRemoved = true;
 		}
-		if (rt.BlackboardComponent.IsValid())
+		else if (item.State != state)
 		{
-			rt.BlackboardComponent->DestroyComponent();
+			item.State = state;
+			LayerSummary.MarkItemDirty(item);
 		}
+	}
+	if (bRemoved)
+	{
+		LayerSummary.MarkArrayDirty();
+	}
 
+	// every remaining item is a running layer, a count mismatch means layers were added
+	if (items.Num() == RunningTrees.Num() + ProcessorLayers.Num())
+	{
+		return;
+	}
+
+	auto addItem = [this, &items](const FName& InId)
+	{
+		if (LayerSummary.Find(InId) == nullptr)
+		{
+			FParallelBehaviorLayerSummaryItem& item = items.AddDefaulted_GetRef();
+			item.Id = InId;
+			item.State = GetLayerState(InId);
+			LayerSummary.MarkItemDirty(item);
+		}
+	};
+	for (const FParallelBehaviorRuntime& rt : RunningTrees)
+	{
+		addItem(rt.Id);
+	}
+	for (const TPair<FName, FParallelBehaviorProcessorHandle>& processorLayer : ProcessorLayers)
+	{
+		addItem(processorLayer.Key);
 	}
-	RunningTrees.Empty();
 }
 
-APawn* UParallelBehaviorManagerComponent::GetPawn_Implementation() const
+FName UParallelBehaviorManagerComponent::GetSnapshotKey() const
 {
-	if (AController* ownerController = GetOwner<AController>())
+	if (!SnapshotKey.IsNone())
 	{
-		return ownerController->GetPawn();
+		return SnapshotKey;
 	}
-	return nullptr;
+
+	const APawn* pawn = GetPawn();
+	const UObject* keyObject = pawn != nullptr ? static_cast<const UObject*>(pawn) : GetOwner();
+	return keyObject != nullptr ? FName(*keyObject->GetPathName()) : NAME_None;
 }
 
-UBehaviorTreeComponent* UParallelBehaviorManagerComponent::GetTree(const FName& InId) const
+uint8* UParallelBehaviorManagerComponent::FindProcessorFragment(const FName& InId, const UScriptStruct*& OutType) const
 {
-	const int32 n = ParallelBehaviorDefaults.Num();
-	for (int32 i = 0; i < n; ++i)
+	OutType = nullptr;
+	const FParallelBehaviorProcessorHandle* handle = ProcessorLayers.Find(InId);
+	UParallelBehaviorSubsystem* subsystem = GetParallelBehaviorSubsystem();
+	return handle != nullptr && subsystem != nullptr ? subsystem->GetProcessorFragment(*handle, OutType) : nullptr;
+}
+
+UBehaviorTreeComponent* UParallelBehaviorManagerComponent::FindTree(const FName& InId) const
+{
+	const int32 index = FindTreeIndex(InId);
+	return index != INDEX_NONE ? RunningTrees[index].TreeComponent.Get() : nullptr;
+}
+
+int32 UParallelBehaviorManagerComponent::FindTreeIndex(const FName& InId) const
+{
+	const int32* index = TreeIndexById.Find(InId);
+	return index != nullptr ? *index : INDEX_NONE;
+}
+
+#if WITH_EDITOR
+void UParallelBehaviorManagerComponent::PreSave(FObjectPreSaveContext InSaveContext)
+{
+	Super::PreSave(InSaveContext);
+
+	PreloadedTrees.Reset();
+	if (bPreloadDefaultTrees)
 	{
-		if (RunningTrees[i].Id == InId)
+		for (const FParallelBehaviorSetup& setup : ParallelBehaviorDefaults)
 		{
-			return RunningTrees[i].TreeComponent.Get();
+			if (setup.Processor == nullptr && !setup.BTAsset.IsNull())
+			{
+				if (UBehaviorTree* tree = setup.BTAsset.LoadSynchronous())
+				{
+					PreloadedTrees.AddUnique(tree);
+				}
+			}
 		}
 	}
-	UE_LOG(LogParallelBehavior, Warning, TEXT("[UParallelBehaviorManagerComponent] Failed to find behavior tree with id '%s'"), *InId.ToString());
-	return nullptr;
-}
\ No newline at end of file
+
+	if (InSaveContext.IsCooking())
+	{
+		ValidateForCook(*this);
+	}
+}
+
+EDataValidationResult UParallelBehaviorManagerComponent::IsDataValid(FDataValidationContext& InContext) const
+{
+	EDataValidationResult result = CombineDataValidationResults(Super::IsDataValid(InContext), EDataValidationResult::Valid);
+
+	// archetype layers and defaults share the Id space of one manager
+	TSet<FName> ids;
+	const bool bRoutesKeys = SharedBlackboardAsset != nullptr || !DefaultSquadId.IsNone();
+	if (Archetype != nullptr)
+	{
+		result = CombineDataValidationResults(result, ValidateSetups(Archetype->Layers,
+			FString::Printf(TEXT("Archetype '%s'"), *Archetype->GetName()), ids, InContext, bLeanLayers, bRoutesKeys));
+	}
+	return CombineDataValidationResults(result, ValidateSetups(ParallelBehaviorDefaults,
+		FString::Printf(TEXT("Behaviors of '%s'"), *GetPathName()), ids, InContext, bLeanLayers, bRoutesKeys));
+}
+
+EDataValidationResult UParallelBehaviorManagerComponent::ValidateSetups(TConstArrayView<FParallelBehaviorSetup> InSetups,
+	const FString& InSetName, TSet<FName>& InOutIds, FDataValidationContext& InContext, bool bInLeanLayers, bool bInRoutesKeys)
+{
+	EDataValidationResult result = EDataValidationResult::Valid;
+	auto addError = [&InContext, &InSetName, &result](int32 InIndex, const FString& InMessage)
+	{
+		InContext.AddError(FText::FromString(FString::Printf(TEXT("%s, layer %d: %s"), *InSetName, InIndex, *InMessage)));
+		result = EDataValidationResult::Invalid;
+	};
+
+	for (int32 i = 0; i < InSetups.Num(); ++i)
+	{
+		const FParallelBehaviorSetup& setup = InSetups[i];
+		if (!setup.Id.IsNone())
+		{
+			bool bAlreadyInSet = false;
+			InOutIds.Add(setup.Id, &bAlreadyInSet);
+			if (bAlreadyInSet)
+			{
+				addError(i, FString::Printf(TEXT("Id '%s' is used by another layer"), *setup.Id.ToString()));
+			}
+		}
+
+		if (setup.Processor != nullptr)
+		{
+			const UScriptStruct* fragmentType = setup.Processor->GetDefaultObject<UParallelBehaviorProcessor>()->GetFragmentType();
+			if (fragmentType == nullptr)
+			{
+				addError(i, FString::Printf(TEXT("Processor '%s' has no fragment type"), *setup.Processor->GetName()));
+			}
+			else if (setup.InitialFragment.IsValid() && setup.InitialFragment.GetScriptStruct() != fragmentType)
+			{
+				addError(i, FString::Printf(TEXT("Initial fragment '%s' does not match fragment '%s' of processor '%s'"),
+					*GetNameSafe(setup.InitialFragment.GetScriptStruct()), *fragmentType->GetName(), *setup.Processor->GetName()));
+			}
+			continue;
+		}
+
+		if (setup.BTAsset.IsNull())
+		{
+			addError(i, TEXT("No behavior tree or processor set"));
+			continue;
+		}
+
+		const UBehaviorTree* tree = setup.BTAsset.LoadSynchronous();
+		if (tree == nullptr)
+		{
+			addError(i, FString::Printf(TEXT("Behavior tree '%s' cannot be loaded"), *setup.BTAsset.ToString()));
+		}
+		else if (tree->BlackboardAsset == nullptr)
+		{
+			const TCHAR* blackboardFeature = setup.InitialValues.Num() > 0 ? TEXT("initial values")
+				: setup.WakeKeys.Num() > 0 ? TEXT("wake keys")
+				: setup.TickCondition != nullptr ? TEXT("a tick condition")
+				: bInRoutesKeys ? TEXT("shared or squad keys")
+				: nullptr;
+			if (blackboardFeature != nullptr)
+			{
+				addError(i, FString::Printf(TEXT("Behavior tree '%s' has no blackboard asset but the layer uses %s"),
+					*tree->GetName(), blackboardFeature));
+			}
+			else if (!bInLeanLayers)
+			{
+				InContext.AddWarning(FText::FromString(FString::Printf(TEXT("%s, layer %d: Behavior tree '%s' has no blackboard asset, enable Lean Layers if that is intended"),
+					*InSetName, i, *tree->GetName())));
+			}
+		}
+	}
+	return result;
+}
+
+void UParallelBehaviorManagerComponent::ValidateForCook(const UObject& InObject)
+{
+	FDataValidationContext context;
+	if (InObject.IsDataValid(context) != EDataValidationResult::Invalid)
+	{
+		return;
+	}
+
+	for (const FDataValidationContext::FIssue& issue : context.GetIssues())
+	{
+		if (issue.Severity == EMessageSeverity::Error)
+		{
+			UE_LOG(LogParallelBehavior, Error, TEXT("%s: %s"), *InObject.GetPathName(), *issue.Message.ToString());
+		}
+	}
+}
+#endif // WITH_EDITOR
\ No newline at end of file
@@ -0,0 +1,36 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Conditions/ParallelBehaviorTickCondition.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+
+
+void UParallelBehaviorTickCondition_Blackboard::ResolveKeys(const UBlackboardData& InAsset, TArray<FBlackboard::FKey>& OutKeys) const
+{
+	OutKeys.Add(InAsset.GetKeyID(KeyName));
+}
+
+bool UParallelBehaviorTickCondition_Blackboard::IsSatisfied(const UBlackboardComponent& InBlackboard,
+	TConstArrayView<FBlackboard::FKey> InKeys) const
+{
+	if (InKeys.Num() == 0 || InKeys[0] == FBlackboard::InvalidKey)
+	{
+		// misconfigured conditions never block the layer
+		return true;
+	}
+
+	const FBlackboard::FKey key = InKeys[0];
+	const UBlackboardData* asset = InBlackboard.GetBlackboardAsset();
+	const TSubclassOf<UBlackboardKeyType> keyType = asset != nullptr ? asset->GetKeyType(key) : nullptr;
+
+	if (keyType == UBlackboardKeyType_Bool::StaticClass())
+	{
+		return InBlackboard.GetValue<UBlackboardKeyType_Bool>(key) == bExpectedValue;
+	}
+	if (keyType == UBlackboardKeyType_Object::StaticClass())
+	{
+		return (InBlackboard.GetValue<UBlackboardKeyType_Object>(key) != nullptr) == bExpectedValue;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Debug/GameplayDebuggerCategory_ParallelBehavior.h"
+
+#if WITH_GAMEPLAY_DEBUGGER_MENU
+
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "Subsystems/ParallelBehaviorSubsystem.h"
+
+#include "BehaviorTree/BTNode.h"
+#include "CanvasItem.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+
+FGameplayDebuggerCategory_ParallelBehavior::FGameplayDebuggerCategory_ParallelBehavior()
+{
+	SetDataPackReplication<FRepData>(&DataPack);
+	BindKeyPress(EKeys::J.GetFName(), FGameplayDebuggerInputModifier::Shift, this,
+		&FGameplayDebuggerCategory_ParallelBehavior::OnCycleLayer, EGameplayDebuggerInputMode::Replicated);
+}
+
+TSharedRef<FGameplayDebuggerCategory> FGameplayDebuggerCategory_ParallelBehavior::MakeInstance()
+{
+	return MakeShareable(new FGameplayDebuggerCategory_ParallelBehavior());
+}
+
+void FGameplayDebuggerCategory_ParallelBehavior::FRepData::Serialize(FArchive& Ar)
+{
+	Ar << OwnerName;
+	Ar << NumProcessorLayers;
+	Ar << SelectedLayer;
+	Ar << SelectedBlackboard;
+
+	int32 numLayers = Layers.Num();
+	Ar << numLayers;
+	if (Ar.IsLoading())
+	{
+		Layers.SetNum(numLayers);
+	}
+	for (FLayerData& layer : Layers)
+	{
+		Ar << layer.Id;
+		Ar << layer.State;
+		Ar << layer.ActiveNode;
+		Ar << layer.TickCount;
+		Ar << layer.LastTickMs;
+		Ar << layer.AverageTickMs;
+		Ar << layer.PeakTickMs;
+		Ar << layer.HistoryMs;
+	}
+}
+
+const UParallelBehaviorManagerComponent* FGameplayDebuggerCategory_ParallelBehavior::FindManager(const AActor* InDebugActor)
+{
+	if (InDebugActor == nullptr)
+	{
+		return nullptr;
+	}
+
+	const UParallelBehaviorManagerComponent* manager = InDebugActor->FindComponentByClass<UParallelBehaviorManagerComponent>();
+	if (manager == nullptr)
+	{
+		const APawn* pawn = Cast<APawn>(InDebugActor);
+		const AController* controller = pawn != nullptr ? pawn->GetController() : nullptr;
+		manager = controller != nullptr ? controller->FindComponentByClass<UParallelBehaviorManagerComponent>() : nullptr;
+	}
+	return manager;
+}
+
+void FGameplayDebuggerCategory_ParallelBehavior::CollectData(APlayerController* OwnerPC, AActor* DebugActor)
+{
+	DataPack = FRepData();
+
+	const UParallelBehaviorManagerComponent* manager = FindManager(DebugActor);
+	if (manager == nullptr)
+	{
+		return;
+	}
+
+	DataPack.OwnerName = GetNameSafe(manager->GetOwner());
+	DataPack.NumProcessorLayers = manager->GetNumProcessorLayers();
+
+	const UWorld* world = manager->GetWorld();
+	const UParallelBehaviorSubsystem* subsystem = world != nullptr ? world->GetSubsystem<UParallelBehaviorSubsystem>() : nullptr;
+	const TArray<FParallelBehaviorRuntime>& runningTrees = manager->GetRunningTrees();
+	const UEnum* stateEnum = StaticEnum<EParallelBehaviorLayerState>();
+
+	DataPack.Layers.Reserve(runningTrees.Num());
+	for (const FParallelBehaviorRuntime& rt : runningTrees)
+	{
+		FLayerData& layer = DataPack.Layers.AddDefaulted_GetRef();
+		layer.Id = rt.Id.ToString();
+		layer.State = stateEnum->GetNameStringByValue(static_cast<int64>(manager->GetLayerState(rt.Id)));
+
+		const UBehaviorTreeComponent* tree = rt.TreeComponent.Get();
+		const UBTNode* activeNode = tree != nullptr ? tree->GetActiveNode() : nullptr;
+		layer.ActiveNode = activeNode != nullptr ? activeNode->GetNodeName() : TEXT("None");
+
+		if (subsystem == nullptr)
+		{
+			continue;
+		}
+
+		FParallelBehaviorLayerStats stats;
+		if (subsystem->GetLayerStats(rt.LayerHandle, stats))
+		{
+			layer.TickCount = stats.TickCount;
+			layer.LastTickMs = stats.LastTickMs;
+			layer.AverageTickMs = stats.AverageTickMs;
+		}
+
+		if (const FParallelBehaviorTickHistory* history = subsystem->GetLayerTickHistory(rt.LayerHandle))
+		{
+			layer.PeakTickMs = static_cast<float>(FPlatformTime::ToMilliseconds64(history->GetPeakCycles()));
+			layer.HistoryMs.Reserve(history->Num());
+			for (int32 age = history->Num() - 1; age >= 0; --age)
+			{
+				layer.HistoryMs.Add(static_cast<float>(FPlatformTime::ToMilliseconds64(history->GetCyclesAgo(age))));
+			}
+		}
+	}
+
+	if (runningTrees.Num() > 0)
+	{
+		DataPack.SelectedLayer = SelectedLayer % runningTrees.Num();
+		if (const UBlackboardComponent* blackboard = runningTrees[DataPack.SelectedLayer].BlackboardComponent.Get())
+		{
+			DataPack.SelectedBlackboard = blackboard->GetDebugInfoString(EBlackboardDescription::KeyWithValue);
+		}
+	}
+}
+
+void FGameplayDebuggerCategory_ParallelBehavior::DrawData(APlayerController* OwnerPC, FGameplayDebuggerCanvasContext& CanvasContext)
+{
+	if (DataPack.OwnerName.IsEmpty())
+	{
+		CanvasContext.Print(TEXT("{red}No parallel behavior manager on the debug actor"));
+		return;
+	}
+
+	CanvasContext.Printf(TEXT("Manager of {yellow}%s{white}: %d tree layers, %d processor layers. %s selects the Blackboard layer"),
+		*DataPack.OwnerName, DataPack.Layers.Num(), DataPack.NumProcessorLayers, *GetInputHandlerDescription(0));
+
+	const float lineHeight = CanvasContext.GetLineHeight();
+	for (int32 i = 0; i < DataPack.Layers.Num(); ++i)
+	{
+		const FLayerData& layer = DataPack.Layers[i];
+		CanvasContext.Printf(TEXT("%s{yellow}%s {white}[%s] node {green}%s{white} | ticks %d, last %.3f ms, avg %.3f ms, peak %.3f ms"),
+			i == DataPack.SelectedLayer ? TEXT("{cyan}> ") : TEXT("  "), *layer.Id, *layer.State, *layer.ActiveNode,
+			layer.TickCount, layer.LastTickMs, layer.AverageTickMs, layer.PeakTickMs);
+
+		if (layer.HistoryMs.Num() == 0 || layer.PeakTickMs <= 0.0f)
+		{
+			continue;
+		}
+
+		// tick cost bar graph of the recorded history, scaled to the peak
+		const float barWidth = 3.0f;
+		const float originX = CanvasContext.CursorX + 16.0f;
+		const float originY = CanvasContext.CursorY;
+		for (int32 sample = 0; sample < layer.HistoryMs.Num(); ++sample)
+		{
+			const float height = FMath::Max(1.0f, lineHeight * layer.HistoryMs[sample] / layer.PeakTickMs);
+			FCanvasTileItem bar(FVector2D(0.0f, 0.0f), FVector2D(barWidth - 1.0f, height), FLinearColor(0.2f, 0.8f, 0.2f, 0.8f));
+			bar.BlendMode = SE_BLEND_Translucent;
+			CanvasContext.DrawItem(bar, originX + sample * barWidth, originY + lineHeight - height);
+		}
+		CanvasContext.MoveToNewLine();
+	}
+
+	if (DataPack.SelectedLayer != INDEX_NONE && DataPack.Layers.IsValidIndex(DataPack.SelectedLayer))
+	{
+		CanvasContext.Printf(TEXT("\nBlackboard of {yellow}%s"), *DataPack.Layers[DataPack.SelectedLayer].Id);
+		TArray<FString> lines;
+		DataPack.SelectedBlackboard.ParseIntoArrayLines(lines);
+		for (const FString& line : lines)
+		{
+			CanvasContext.Print(line);
+		}
+	}
+}
+
+void FGameplayDebuggerCategory_ParallelBehavior::OnCycleLayer()
+{
+	// wrapped against the layer count when collecting, the set changes at runtime
+	SelectedLayer = SelectedLayer < MAX_int32 ? SelectedLayer + 1 : 0;
+}
+
+#endif // WITH_GAMEPLAY_DEBUGGER_MENU
\ No newline at end of file
@@ -0,0 +1,68 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_GAMEPLAY_DEBUGGER_MENU
+
+#include "GameplayDebuggerCategory.h"
+
+class UParallelBehaviorManagerComponent;
+
+/**
+ * @class FGameplayDebuggerCategory_ParallelBehavior
+ * @brief Gameplay debugger category listing every layer of the debug actor's manager
+ *
+ * The stock behavior tree category only follows the controller's BrainComponent. This one shows each
+ * layer's state, active node and recent managed tick cost, plus the Blackboard of the selected layer.
+ */
+class FGameplayDebuggerCategory_ParallelBehavior : public FGameplayDebuggerCategory
+{
+public:
+	FGameplayDebuggerCategory_ParallelBehavior();
+
+	virtual void CollectData(APlayerController* OwnerPC, AActor* DebugActor) override;
+	virtual void DrawData(APlayerController* OwnerPC, FGameplayDebuggerCanvasContext& CanvasContext) override;
+
+	static TSharedRef<FGameplayDebuggerCategory> MakeInstance();
+
+protected:
+	/** Selects the next layer for the Blackboard view */
+	void OnCycleLayer();
+
+	/** Manager on the debug actor, or on the controller of a debugged pawn */
+	static const UParallelBehaviorManagerComponent* FindManager(const AActor* InDebugActor);
+
+	struct FLayerData
+	{
+		FString Id;
+		FString State;
+		FString ActiveNode;
+		int32 TickCount = 0;
+		float LastTickMs = 0.0f;
+		float AverageTickMs = 0.0f;
+		float PeakTickMs = 0.0f;
+
+		/** Cost of the last managed ticks, oldest first */
+		TArray<float> HistoryMs;
+	};
+
+	struct FRepData
+	{
+		FString OwnerName;
+		int32 NumProcessorLayers = 0;
+		int32 SelectedLayer = INDEX_NONE;
+		FString SelectedBlackboard;
+		TArray<FLayerData> Layers;
+
+		void Serialize(FArchive& Ar);
+	};
+
+	FRepData DataPack;
+
+	/** Layer whose Blackboard is collected, wraps around the layer count */
+	int32 SelectedLayer = 0;
+};
+
+#endif // WITH_GAMEPLAY_DEBUGGER_MENU
\ No newline at end of file
@@ -0,0 +1,59 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Decorators/BTDecorator_ParallelBehaviorMessage.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "ParallelBehaviorMessage.h"
+
+#include "BehaviorTree/BehaviorTreeComponent.h"
+
+
+UBTDecorator_ParallelBehaviorMessage::UBTDecorator_ParallelBehaviorMessage()
+{
+	NodeName = TEXT("Parallel Has Message");
+	bNotifyBecomeRelevant = true;
+	bNotifyCeaseRelevant = true;
+}
+
+bool UBTDecorator_ParallelBehaviorMessage::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	FParallelBehaviorLayerNodeMemory* memory = CastInstanceNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory);
+	const UParallelBehaviorManagerComponent* manager = memory->Resolve(OwnerComp);
+	return manager != nullptr && manager->HasMessageForSlot(manager->GetMessageSlot(memory->LayerId), MessageType);
+}
+
+void UBTDecorator_ParallelBehaviorMessage::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	// the outer is enough here, the layer may not be registered yet while the tree starts
+	if (UParallelBehaviorManagerComponent* manager = Cast<UParallelBehaviorManagerComponent>(OwnerComp.GetOuter()))
+	{
+		manager->AddMessageWatcher(OwnerComp, *this);
+	}
+}
+
+void UBTDecorator_ParallelBehaviorMessage::OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	if (UParallelBehaviorManagerComponent* manager = Cast<UParallelBehaviorManagerComponent>(OwnerComp.GetOuter()))
+	{
+		manager->RemoveMessageWatcher(OwnerComp, *this);
+	}
+}
+
+uint16 UBTDecorator_ParallelBehaviorMessage::GetInstanceMemorySize() const
+{
+	return sizeof(FParallelBehaviorLayerNodeMemory);
+}
+
+void UBTDecorator_ParallelBehaviorMessage::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory, InitType);
+}
+
+void UBTDecorator_ParallelBehaviorMessage::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory, CleanupType);
+}
+
+FString UBTDecorator_ParallelBehaviorMessage::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s: message %s waiting"), *Super::GetStaticDescription(),
+		MessageType.IsValid() ? *MessageType.ToString() : TEXT("of any type"));
+}
\ No newline at end of file
@@ -1,20 +1,68 @@
 ﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ParallelBehavior.h"
+#include "ParallelBehaviorAssetCache.h"
+#include "ParallelBehaviorStats.h"
+
+#include "BehaviorTree/BlackboardData.h"
+
+#if WITH_GAMEPLAY_DEBUGGER_MENU
+#include "GameplayDebugger.h"
+#include "Debug/GameplayDebuggerCategory_ParallelBehavior.h"
+#endif
 
 #define LOCTEXT_NAMESPACE "FParallelBehaviorModule"
 
 DEFINE_LOG_CATEGORY(LogParallelBehavior);
 
+DEFINE_STAT(STAT_ParallelBehavior_AddTree);
+DEFINE_STAT(STAT_ParallelBehavior_RemoveTree);
+DEFINE_STAT(STAT_ParallelBehavior_BlackboardInit);
+DEFINE_STAT(STAT_ParallelBehavior_ManagedTick);
+DEFINE_STAT(STAT_ParallelBehavior_TickConditions);
+DEFINE_STAT(STAT_ParallelBehavior_UpdateLODs);
+DEFINE_STAT(STAT_ParallelBehavior_Processors);
+DEFINE_STAT(STAT_ParallelBehavior_ActiveTrees);
+DEFINE_STAT(STAT_ParallelBehavior_ManagedTicks);
+DEFINE_STAT(STAT_ParallelBehavior_DeferredTicks);
+DEFINE_STAT(STAT_ParallelBehavior_SkippedTicks);
+DEFINE_STAT(STAT_ParallelBehavior_ProcessorLayers);
+DEFINE_STAT(STAT_ParallelBehavior_PooledPairs);
+
+UE_TRACE_CHANNEL_DEFINE(ParallelBehaviorChannel);
+
 void FParallelBehaviorModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	BlackboardKeysUpdatedHandle = UBlackboardData::OnUpdateKeys.AddLambda([](UBlackboardData* InAsset)
+	{
+		FParallelBehaviorAssetCache::Get().Invalidate(InAsset);
+	});
+
+#if WITH_GAMEPLAY_DEBUGGER_MENU
+	IGameplayDebugger& gameplayDebugger = IGameplayDebugger::Get();
+	gameplayDebugger.RegisterCategory("ParallelBehavior",
+		IGameplayDebugger::FOnGetCategory::CreateStatic(&FGameplayDebuggerCategory_ParallelBehavior::MakeInstance),
+		EGameplayDebuggerCategoryState::EnabledInGameAndSimulate);
+	gameplayDebugger.NotifyCategoriesChanged();
+#endif
 }
 
 void FParallelBehaviorModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	UBlackboardData::OnUpdateKeys.Remove(BlackboardKeysUpdatedHandle);
+	FParallelBehaviorAssetCache::Get().Reset();
+
+#if WITH_GAMEPLAY_DEBUGGER_MENU
+	if (IGameplayDebugger::IsAvailable())
+	{
+		IGameplayDebugger& gameplayDebugger = IGameplayDebugger::Get();
+		gameplayDebugger.UnregisterCategory("ParallelBehavior");
+		gameplayDebugger.NotifyCategoriesChanged();
+	}
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
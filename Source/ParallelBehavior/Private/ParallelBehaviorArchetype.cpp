@@ -0,0 +1,164 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorArchetype.h"
+#include "ParallelBehavior.h"
+#include "ParallelBehaviorAssetCache.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Misc/App.h"
+#include "Misc/DataValidation.h"
+#include "UObject/ObjectSaveContext.h"
+
+
+void UParallelBehaviorArchetype::PostLoad()
+{
+	Super::PostLoad();
+
+	// editor and commandlets load archetypes for editing and cooking only
+	if (bPreloadTrees && FApp::IsGame() && IsInGameThread() && !HasAnyFlags(RF_ClassDefaultObject))
+	{
+		ResolveAsync(FSimpleDelegate());
+	}
+}
+
+bool UParallelBehaviorArchetype::ResolveAsync(FSimpleDelegate InOnResolved)
+{
+	if (bResolved)
+	{
+		InOnResolved.ExecuteIfBound();
+		return true;
+	}
+
+	if (InOnResolved.IsBound())
+	{
+		PendingCallbacks.Add(MoveTemp(InOnResolved));
+	}
+
+	if (LoadHandle.IsValid() && !LoadHandle->WasCanceled())
+	{
+		return true;
+	}
+
+	TArray<FSoftObjectPath> pathsToLoad;
+	pathsToLoad.Reserve(Layers.Num());
+	bool bHasTrees = false;
+	for (const FParallelBehaviorSetup& layer : Layers)
+	{
+		bHasTrees |= layer.Processor != nullptr;
+		if (layer.Processor != nullptr || layer.BTAsset.IsNull())
+		{
+			continue;
+		}
+
+		bHasTrees = true;
+		if (!layer.BTAsset.IsValid())
+		{
+			pathsToLoad.AddUnique(layer.BTAsset.ToSoftObjectPath());
+		}
+	}
+
+	if (!bHasTrees)
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("ResolveAsync: Archetype '%s' has no layer to run"), *GetName());
+		PendingCallbacks.Empty();
+		return false;
+	}
+
+	if (pathsToLoad.Num() == 0)
+	{
+		FinishResolve();
+		return true;
+	}
+
+	FStreamableManager& streamable = UAssetManager::GetStreamableManager();
+	LoadHandle = streamable.RequestAsyncLoad(MoveTemp(pathsToLoad),
+		FStreamableDelegate::CreateWeakLambda(this, [this]()
+		{
+			FinishResolve();
+		}));
+	return true;
+}
+
+bool UParallelBehaviorArchetype::ResolveSynchronous()
+{
+	if (bResolved)
+	{
+		return true;
+	}
+
+	bool bHasTrees = false;
+	for (const FParallelBehaviorSetup& layer : Layers)
+	{
+		bHasTrees |= layer.Processor != nullptr;
+		if (layer.Processor == nullptr && !layer.BTAsset.IsNull())
+		{
+			bHasTrees = true;
+			layer.BTAsset.LoadSynchronous();
+		}
+	}
+
+	if (!bHasTrees)
+	{
+		return false;
+	}
+
+	FinishResolve();
+	return true;
+}
+
+void UParallelBehaviorArchetype::FinishResolve()
+{
+	if (bResolved)
+	{
+		return;
+	}
+
+	ResolvedTrees.Reset(Layers.Num());
+	for (const FParallelBehaviorSetup& layer : Layers)
+	{
+		UBehaviorTree* tree = layer.Processor == nullptr ? layer.BTAsset.Get() : nullptr;
+		if (tree == nullptr)
+		{
+			if (layer.Processor == nullptr && !layer.BTAsset.IsNull())
+			{
+				UE_LOG(LogParallelBehavior, Warning, TEXT("FinishResolve: Archetype '%s' failed to load behavior tree '%s'"),
+					*GetName(), *layer.BTAsset.ToString());
+			}
+			continue;
+		}
+
+		ResolvedTrees.AddUnique(tree);
+		if (tree->BlackboardAsset != nullptr)
+		{
+			FParallelBehaviorAssetCache::Get().GetLayout(*tree->BlackboardAsset);
+		}
+	}
+
+	bResolved = true;
+	LoadHandle.Reset();
+
+	TArray<FSimpleDelegate> callbacks = MoveTemp(PendingCallbacks);
+	for (const FSimpleDelegate& callback : callbacks)
+	{
+		callback.ExecuteIfBound();
+	}
+}
+
+#if WITH_EDITOR
+void UParallelBehaviorArchetype::PreSave(FObjectPreSaveContext InSaveContext)
+{
+	Super::PreSave(InSaveContext);
+
+	if (InSaveContext.IsCooking())
+	{
+		UParallelBehaviorManagerComponent::ValidateForCook(*this);
+	}
+}
+
+EDataValidationResult UParallelBehaviorArchetype::IsDataValid(FDataValidationContext& InContext) const
+{
+	TSet<FName> ids;
+	return CombineDataValidationResults(Super::IsDataValid(InContext),
+		UParallelBehaviorManagerComponent::ValidateSetups(Layers, FString::Printf(TEXT("Archetype '%s'"), *GetName()), ids, InContext));
+}
+#endif // WITH_EDITOR
\ No newline at end of file
@@ -0,0 +1,106 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorAssetCache.h"
+
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Class.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+
+FParallelBehaviorAssetCache& FParallelBehaviorAssetCache::Get()
+{
+	static FParallelBehaviorAssetCache instance;
+	return instance;
+}
+
+const FParallelBehaviorBlackboardLayout& FParallelBehaviorAssetCache::GetLayout(const UBlackboardData& InAsset)
+{
+	check(IsInGameThread());
+
+	if (const FParallelBehaviorBlackboardLayout* layout = Layouts.Find(&InAsset))
+	{
+		return *layout;
+	}
+
+	FParallelBehaviorBlackboardLayout& layout = Layouts.Add(&InAsset);
+	const int32 numKeys = InAsset.GetNumKeys();
+	layout.KeyIds.Reserve(numKeys);
+	for (int32 i = 0; i < numKeys; ++i)
+	{
+		const FBlackboard::FKey key = static_cast<FBlackboard::FKey>(i);
+		layout.KeyIds.Add(InAsset.GetKeyName(key), key);
+
+		const FBlackboardEntry* entry = InAsset.GetKey(key);
+		if (entry == nullptr || entry->KeyType == nullptr)
+		{
+			continue;
+		}
+
+		const UBlackboardKeyType* keyType = entry->KeyType;
+		layout.ValueMemorySize += keyType->GetValueSize();
+		if (keyType->IsA<UBlackboardKeyType_String>())
+		{
+			layout.StringKeys.Add(key);
+		}
+		else if (keyType->IsA<UBlackboardKeyType_Bool>() || keyType->IsA<UBlackboardKeyType_Int>()
+			|| keyType->IsA<UBlackboardKeyType_Float>() || keyType->IsA<UBlackboardKeyType_Enum>()
+			|| keyType->IsA<UBlackboardKeyType_NativeEnum>() || keyType->IsA<UBlackboardKeyType_Name>()
+			|| keyType->IsA<UBlackboardKeyType_Vector>() || keyType->IsA<UBlackboardKeyType_Rotator>()
+			|| keyType->IsA<UBlackboardKeyType_Object>() || keyType->IsA<UBlackboardKeyType_Class>())
+		{
+			layout.SnapshotKeys.Add(key);
+			layout.SnapshotKeySizes.Add(keyType->GetValueSize());
+			layout.SnapshotSize += keyType->GetValueSize();
+		}
+	}
+	layout.SelfKey = layout.Find(FBlackboard::KeySelf);
+
+	// the self key is set for the new pawn on every start, never restored
+	const int32 selfIndex = layout.SnapshotKeys.Find(layout.SelfKey);
+	if (selfIndex != INDEX_NONE)
+	{
+		layout.SnapshotSize -= layout.SnapshotKeySizes[selfIndex];
+		layout.SnapshotKeys.RemoveAt(selfIndex);
+		layout.SnapshotKeySizes.RemoveAt(selfIndex);
+	}
+	return layout;
+}
+
+const FParallelBehaviorBlackboardLayout* FParallelBehaviorAssetCache::GetLayout(const UBehaviorTree& InTree)
+{
+	return InTree.BlackboardAsset != nullptr ? &GetLayout(*InTree.BlackboardAsset) : nullptr;
+}
+
+FBlackboard::FKey FParallelBehaviorAssetCache::GetKeyID(const UBlackboardData& InAsset, const FName& InKeyName)
+{
+	return GetLayout(InAsset).Find(InKeyName);
+}
+
+void FParallelBehaviorAssetCache::ResolveKeys(const UBlackboardData& InAsset, TConstArrayView<FName> InKeyNames,
+	TArray<FBlackboard::FKey>& OutKeys)
+{
+	const FParallelBehaviorBlackboardLayout& layout = GetLayout(InAsset);
+	OutKeys.Reset(InKeyNames.Num());
+	for (const FName& keyName : InKeyNames)
+	{
+		OutKeys.Add(layout.Find(keyName));
+	}
+}
+
+void FParallelBehaviorAssetCache::Invalidate(const UBlackboardData* InAsset)
+{
+	Layouts.Remove(InAsset);
+}
+
+void FParallelBehaviorAssetCache::Reset()
+{
+	Layouts.Empty();
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorBenchmark.h"
+#include "ParallelBehavior.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+
+#include "AIController.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace ParallelBehaviorBenchmark
+{
+	FString ToCsv(const FResult& InResult)
+	{
+		FString csv = TEXT("engine,tree,agents,layers,frames,churn_cycles,started_layers,spawn_ms,spawn_us_per_layer,frame_ms,")
+			TEXT("lookup_ns,churn_us,teardown_ms,memory_delta_bytes,peak_memory_bytes,uobject_delta\n");
+		csv += FString::Printf(TEXT("%s,%s,%d,%d,%d,%d,%d,%.3f,%.3f,%.4f,%.2f,%.3f,%.3f,%lld,%lld,%d\n"),
+			*FEngineVersion::Current().ToString(), *InResult.TreePath, InResult.Agents, InResult.Layers, InResult.Frames,
+			InResult.ChurnCycles, InResult.StartedLayers, InResult.SpawnMs,
+			InResult.StartedLayers > 0 ? InResult.SpawnMs * 1000.0 / InResult.StartedLayers : 0.0,
+			InResult.FrameMs, InResult.LookupNs, InResult.ChurnUs, InResult.TeardownMs,
+			InResult.MemoryDeltaBytes, InResult.PeakMemoryBytes, InResult.ObjectDelta);
+		return csv;
+	}
+
+	FString ToJson(const FResult& InResult)
+	{
+		return FString::Printf(TEXT("{\n")
+			TEXT("\t\"engine\": \"%s\",\n\t\"tree\": \"%s\",\n")
+			TEXT("\t\"agents\": %d,\n\t\"layers\": %d,\n\t\"frames\": %d,\n\t\"churn_cycles\": %d,\n\t\"started_layers\": %d,\n")
+			TEXT("\t\"spawn_ms\": %.3f,\n\t\"frame_ms\": %.4f,\n\t\"lookup_ns\": %.2f,\n\t\"churn_us\": %.3f,\n\t\"teardown_ms\": %.3f,\n")
+			TEXT("\t\"memory_delta_bytes\": %lld,\n\t\"peak_memory_bytes\": %lld,\n\t\"uobject_delta\": %d\n}\n"),
+			*FEngineVersion::Current().ToString(), *InResult.TreePath.ReplaceCharWithEscapedChar(),
+			InResult.Agents, InResult.Layers, InResult.Frames, InResult.ChurnCycles, InResult.StartedLayers,
+			InResult.SpawnMs, InResult.FrameMs, InResult.LookupNs, InResult.ChurnUs, InResult.TeardownMs,
+			InResult.MemoryDeltaBytes, InResult.PeakMemoryBytes, InResult.ObjectDelta);
+	}
+
+	bool RunScenario(UWorld* InWorld, UBehaviorTree* InBTAsset, FResult& InOutResult)
+	{
+		if (InWorld == nullptr || !InWorld->IsGameWorld() || InBTAsset == nullptr)
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("pb.Benchmark: Needs a game world and a behavior tree"));
+			return false;
+		}
+
+		FResult& result = InOutResult;
+		const int32 startObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		const uint64 startMemory = FPlatformMemory::GetStats().UsedPhysical;
+
+		// spawn: what RunDefaultTrees does for every agent
+		TArray<AAIController*> controllers;
+		TArray<UParallelBehaviorManagerComponent*> managers;
+		controllers.Reserve(result.Agents);
+		managers.Reserve(result.Agents);
+
+		FActorSpawnParameters spawnParams;
+		spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		for (int32 i = 0; i < result.Agents; ++i)
+		{
+			AAIController* controller = InWorld->SpawnActor<AAIController>(AAIController::StaticClass(), FTransform::Identity, spawnParams);
+			if (controller == nullptr)
+			{
+				continue;
+			}
+
+			UParallelBehaviorManagerComponent* manager = NewObject<UParallelBehaviorManagerComponent>(controller);
+			manager->RegisterComponent();
+			controllers.Add(controller);
+			managers.Add(manager);
+		}
+
+		FParallelBehaviorSetup setup;
+		setup.BTAsset = InBTAsset;
+
+		const double spawnStart = FPlatformTime::Seconds();
+		for (UParallelBehaviorManagerComponent* manager : managers)
+		{
+			for (int32 layer = 0; layer < result.Layers; ++layer)
+			{
+				setup.Id = FName(TEXT("Layer"), layer + 1);
+				result.StartedLayers += manager->AddTree(setup) ? 1 : 0;
+			}
+		}
+		result.SpawnMs = (FPlatformTime::Seconds() - spawnStart) * 1000.0;
+
+		result.MemoryDeltaBytes = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(startMemory);
+		result.ObjectDelta = GUObjectArray.GetObjectArrayNumMinusAvailable() - startObjects;
+
+		// per frame: every layer of every agent ticked once
+		const float deltaTime = 1.0f / 60.0f;
+		const double frameStart = FPlatformTime::Seconds();
+		for (int32 frame = 0; frame < result.Frames; ++frame)
+		{
+			for (const UParallelBehaviorManagerComponent* manager : managers)
+			{
+				for (const FParallelBehaviorRuntime& rt : manager->GetRunningTrees())
+				{
+					if (UBehaviorTreeComponent* btComp = rt.TreeComponent.Get())
+					{
+						btComp->TickComponent(deltaTime, LEVELTICK_All, nullptr);
+					}
+				}
+			}
+		}
+		result.FrameMs = result.Frames > 0 ? (FPlatformTime::Seconds() - frameStart) * 1000.0 / result.Frames : 0.0;
+
+		// lookup: every layer Id of every agent
+		int32 lookups = 0;
+		int32 found = 0;
+		const double lookupStart = FPlatformTime::Seconds();
+		for (int32 round = 0; round < 100; ++round)
+		{
+			for (const UParallelBehaviorManagerComponent* manager : managers)
+			{
+				for (int32 layer = 0; layer < result.Layers; ++layer)
+				{
+					found += manager->FindTree(FName(TEXT("Layer"), layer + 1)) != nullptr ? 1 : 0;
+					++lookups;
+				}
+			}
+		}
+		result.LookupNs = lookups > 0 ? (FPlatformTime::Seconds() - lookupStart) * 1.0e9 / lookups : 0.0;
+
+		// churn: remove and re-add the first layer of every agent
+		int32 churns = 0;
+		setup.Id = FName(TEXT("Layer"), 1);
+		const double churnStart = FPlatformTime::Seconds();
+		for (int32 cycle = 0; cycle < result.ChurnCycles; ++cycle)
+		{
+			for (UParallelBehaviorManagerComponent* manager : managers)
+			{
+				manager->RemoveTree(setup.Id);
+				manager->AddTree(setup);
+				++churns;
+			}
+		}
+		result.ChurnUs = churns > 0 ? (FPlatformTime::Seconds() - churnStart) * 1.0e6 / churns : 0.0;
+
+		result.PeakMemoryBytes = static_cast<int64>(FPlatformMemory::GetStats().PeakUsedPhysical);
+		for (const UParallelBehaviorManagerComponent* manager : managers)
+		{
+			result.RunningLayers += manager->GetRunningTrees().Num();
+		}
+
+		const double teardownStart = FPlatformTime::Seconds();
+		for (AAIController* controller : controllers)
+		{
+			controller->Destroy();
+		}
+		result.TeardownMs = (FPlatformTime::Seconds() - teardownStart) * 1000.0;
+
+		UE_LOG(LogParallelBehavior, Display, TEXT("pb.Benchmark: %d agents x %d layers, spawn %.2f ms, frame %.3f ms, lookup %.1f ns (%d found), churn %.2f us, %d UObjects"),
+			result.Agents, result.Layers, result.SpawnMs, result.FrameMs, result.LookupNs, found, result.ChurnUs, result.ObjectDelta);
+		return true;
+	}
+
+	void Run(const TArray<FString>& InArgs, UWorld* InWorld)
+	{
+		const FString args = FString::Join(InArgs, TEXT(" "));
+		FResult result;
+		FParse::Value(*args, TEXT("Tree="), result.TreePath);
+		FParse::Value(*args, TEXT("Agents="), result.Agents);
+		FParse::Value(*args, TEXT("Layers="), result.Layers);
+		FParse::Value(*args, TEXT("Frames="), result.Frames);
+		FParse::Value(*args, TEXT("Churn="), result.ChurnCycles);
+
+		UBehaviorTree* btAsset = LoadObject<UBehaviorTree>(nullptr, *result.TreePath);
+		if (btAsset == nullptr)
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("pb.Benchmark: Unable to load behavior tree '%s'"), *result.TreePath);
+			return;
+		}
+
+		if (!RunScenario(InWorld, btAsset, result))
+		{
+			return;
+		}
+
+		const FString baseName = FPaths::ProfilingDir() / TEXT("ParallelBehavior")
+			/ FString::Printf(TEXT("Benchmark-%s"), *FDateTime::Now().ToString());
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(baseName), true);
+		FFileHelper::SaveStringToFile(ToCsv(result), *(baseName + TEXT(".csv")));
+		FFileHelper::SaveStringToFile(ToJson(result), *(baseName + TEXT(".json")));
+
+		UE_LOG(LogParallelBehavior, Display, TEXT("pb.Benchmark: Results written to %s.csv/.json"), *baseName);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("pb.Benchmark"),
+		TEXT("Spawns AI controllers running parallel layers and measures spawn, tick, lookup and churn cost.\n")
+		TEXT("Usage: pb.Benchmark Tree=/Game/Path/BT_Asset.BT_Asset [Agents=100] [Layers=5] [Frames=120] [Churn=10]\n")
+		TEXT("Results are written as CSV and JSON to Saved/Profiling/ParallelBehavior."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&Run));
+}
+
+#endif // !UE_BUILD_SHIPPING
\ No newline at end of file
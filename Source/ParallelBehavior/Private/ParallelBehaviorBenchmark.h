@@ -0,0 +1,47 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+class UBehaviorTree;
+class UWorld;
+
+namespace ParallelBehaviorBenchmark
+{
+	/** Settings and measurements of one pb.Benchmark run */
+	struct FResult
+	{
+		FString TreePath;
+		int32 Agents = 100;
+		int32 Layers = 5;
+		int32 Frames = 120;
+		int32 ChurnCycles = 10;
+		int32 StartedLayers = 0;
+
+		/** Layers still running after the churn, checked before teardown */
+		int32 RunningLayers = 0;
+
+		double SpawnMs = 0.0;
+		double FrameMs = 0.0;
+		double LookupNs = 0.0;
+		double ChurnUs = 0.0;
+		double TeardownMs = 0.0;
+
+		int64 MemoryDeltaBytes = 0;
+		int64 PeakMemoryBytes = 0;
+		int32 ObjectDelta = 0;
+	};
+
+	/**
+	 * Spawns InOutResult.Agents AI controllers running InOutResult.Layers layers of the tree, measures spawn,
+	 * tick, lookup and churn cost and destroys the controllers again. Also driven by the automation tests.
+	 *
+	 * @return false if the world is not a game world.
+	 */
+	bool RunScenario(UWorld* InWorld, UBehaviorTree* InBTAsset, FResult& InOutResult);
+}
+
+#endif // !UE_BUILD_SHIPPING
\ No newline at end of file
@@ -0,0 +1,116 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorBlackboardUtils.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Class.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+
+namespace
+{
+	template <typename TKeyType>
+	bool CopyTypedValue(const UBlackboardComponent& InSource, FBlackboard::FKey InSourceKey,
+		UBlackboardComponent& InTarget, FBlackboard::FKey InTargetKey)
+	{
+		InTarget.SetValue<TKeyType>(InTargetKey, InSource.GetValue<TKeyType>(InSourceKey));
+		return true;
+	}
+}
+
+bool FParallelBehaviorBlackboardUtils::CopyValue(const UBlackboardComponent& InSource, FBlackboard::FKey InSourceKey,
+	UBlackboardComponent& InTarget, FBlackboard::FKey InTargetKey)
+{
+	const UBlackboardData* sourceAsset = InSource.GetBlackboardAsset();
+	const UBlackboardData* targetAsset = InTarget.GetBlackboardAsset();
+	if (sourceAsset == nullptr || targetAsset == nullptr)
+	{
+		return false;
+	}
+
+	const TSubclassOf<UBlackboardKeyType> keyType = sourceAsset->GetKeyType(InSourceKey);
+	if (keyType == nullptr || keyType != targetAsset->GetKeyType(InTargetKey))
+	{
+		return false;
+	}
+
+	if (keyType == UBlackboardKeyType_Object::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Object>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_Vector::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Vector>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_Bool::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Bool>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_Float::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Float>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_Int::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Int>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_Enum::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Enum>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_NativeEnum::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_NativeEnum>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_Name::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Name>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_String::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_String>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_Rotator::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Rotator>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	if (keyType == UBlackboardKeyType_Class::StaticClass())
+	{
+		return CopyTypedValue<UBlackboardKeyType_Class>(InSource, InSourceKey, InTarget, InTargetKey);
+	}
+	return false;
+}
+
+bool FParallelBehaviorBlackboardUtils::BuildKeyRoutes(const UBlackboardData& InSourceAsset, const UBlackboardData& InTargetAsset,
+	const TArray<FName>& InKeyFilter, TArray<FBlackboard::FKey>& OutRoutes)
+{
+	const int32 numKeys = InSourceAsset.GetNumKeys();
+	OutRoutes.Init(FBlackboard::InvalidKey, numKeys);
+
+	bool bAnyRouted = false;
+	for (int32 i = 0; i < numKeys; ++i)
+	{
+		const FBlackboard::FKey sourceKey = static_cast<FBlackboard::FKey>(i);
+		const FName keyName = InSourceAsset.GetKeyName(sourceKey);
+		if (InKeyFilter.Num() > 0 && !InKeyFilter.Contains(keyName))
+		{
+			continue;
+		}
+
+		const FBlackboard::FKey targetKey = InTargetAsset.GetKeyID(keyName);
+		if (targetKey != FBlackboard::InvalidKey && InTargetAsset.GetKeyType(targetKey) == InSourceAsset.GetKeyType(sourceKey))
+		{
+			OutRoutes[i] = targetKey;
+			bAnyRouted = true;
+		}
+	}
+	return bAnyRouted;
+}
\ No newline at end of file
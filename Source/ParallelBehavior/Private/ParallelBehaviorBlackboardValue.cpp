@@ -0,0 +1,97 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorBlackboardValue.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Class.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+
+bool FParallelBehaviorBlackboardValue::ApplyTo(UBlackboardComponent& InBlackboard, FBlackboard::FKey InKey) const
+{
+	if (InKey == FBlackboard::InvalidKey)
+	{
+		return false;
+	}
+
+	switch (Type)
+	{
+	case EParallelBehaviorValueType::Object:
+		return InBlackboard.SetValue<UBlackboardKeyType_Object>(InKey, ObjectValue.Get());
+	case EParallelBehaviorValueType::Class:
+		return InBlackboard.SetValue<UBlackboardKeyType_Class>(InKey, ClassValue.Get());
+	case EParallelBehaviorValueType::Bool:
+		return InBlackboard.SetValue<UBlackboardKeyType_Bool>(InKey, BoolValue);
+	case EParallelBehaviorValueType::Int:
+		return InBlackboard.SetValue<UBlackboardKeyType_Int>(InKey, IntValue);
+	case EParallelBehaviorValueType::Float:
+		return InBlackboard.SetValue<UBlackboardKeyType_Float>(InKey, FloatValue);
+	case EParallelBehaviorValueType::Enum:
+		// enum keys come in two flavors, SetValue rejects the one that does not match
+		return InBlackboard.SetValue<UBlackboardKeyType_Enum>(InKey, EnumValue)
+			|| InBlackboard.SetValue<UBlackboardKeyType_NativeEnum>(InKey, EnumValue);
+	case EParallelBehaviorValueType::Name:
+		return InBlackboard.SetValue<UBlackboardKeyType_Name>(InKey, NameValue);
+	case EParallelBehaviorValueType::String:
+		return InBlackboard.SetValue<UBlackboardKeyType_String>(InKey, StringValue);
+	case EParallelBehaviorValueType::Vector:
+		return InBlackboard.SetValue<UBlackboardKeyType_Vector>(InKey, VectorValue);
+	case EParallelBehaviorValueType::Rotator:
+		return InBlackboard.SetValue<UBlackboardKeyType_Rotator>(InKey, RotatorValue);
+	default:
+		return false;
+	}
+}
+
+FParallelBehaviorBlackboardValue FParallelBehaviorBlackboardValue::MakeObject(FName InKey, UObject* InValue)
+{
+	FParallelBehaviorBlackboardValue value;
+	value.Key = InKey;
+	value.Type = EParallelBehaviorValueType::Object;
+	value.ObjectValue = InValue;
+	return value;
+}
+
+FParallelBehaviorBlackboardValue FParallelBehaviorBlackboardValue::MakeBool(FName InKey, bool bInValue)
+{
+	FParallelBehaviorBlackboardValue value;
+	value.Key = InKey;
+	value.Type = EParallelBehaviorValueType::Bool;
+	value.BoolValue = bInValue;
+	return value;
+}
+
+FParallelBehaviorBlackboardValue FParallelBehaviorBlackboardValue::MakeInt(FName InKey, int32 InValue)
+{
+	FParallelBehaviorBlackboardValue value;
+	value.Key = InKey;
+	value.Type = EParallelBehaviorValueType::Int;
+	value.IntValue = InValue;
+	return value;
+}
+
+FParallelBehaviorBlackboardValue FParallelBehaviorBlackboardValue::MakeFloat(FName InKey, float InValue)
+{
+	FParallelBehaviorBlackboardValue value;
+	value.Key = InKey;
+	value.Type = EParallelBehaviorValueType::Float;
+	value.FloatValue = InValue;
+	return value;
+}
+
+FParallelBehaviorBlackboardValue FParallelBehaviorBlackboardValue::MakeVector(FName InKey, const FVector& InValue)
+{
+	FParallelBehaviorBlackboardValue value;
+	value.Key = InKey;
+	value.Type = EParallelBehaviorValueType::Vector;
+	value.VectorValue = InValue;
+	return value;
+}
\ No newline at end of file
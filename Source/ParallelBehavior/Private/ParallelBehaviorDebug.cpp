@@ -0,0 +1,84 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorDebug.h"
+#include "ParallelBehaviorStats.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BTNode.h"
+#include "ObjectTrace.h"
+#include "Trace/Trace.inl"
+
+#if PARALLEL_BEHAVIOR_TRACE_ENABLED
+
+namespace ParallelBehaviorTrace
+{
+	/** Object trace id when object tracing is on, so events line up with the manager in the Rewind Debugger */
+	uint64 GetManagerId(const UParallelBehaviorManagerComponent* InManager)
+	{
+#if OBJECT_TRACE_ENABLED
+		return FObjectTrace::GetObjectId(InManager);
+#else
+		return reinterpret_cast<uint64>(InManager);
+#endif
+	}
+}
+
+UE_TRACE_EVENT_BEGIN(ParallelBehavior, LayerTick)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, DurationCycles)
+	UE_TRACE_EVENT_FIELD(uint64, ManagerId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, LayerId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, ActiveNode)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ParallelBehavior, LayerLifetime)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, ManagerId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, LayerId)
+	UE_TRACE_EVENT_FIELD(bool, bAdded)
+UE_TRACE_EVENT_END()
+
+void FParallelBehaviorTrace::OutputLayerTick(const UParallelBehaviorManagerComponent* InManager, const FName& InLayerId,
+	const UBehaviorTreeComponent& InTree, uint64 InStartCycles, uint64 InCycles)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(ParallelBehaviorChannel))
+	{
+		return;
+	}
+
+	// names go through stack buffers, tracing a tick does not allocate
+	TStringBuilder<128> layerId;
+	InLayerId.AppendString(layerId);
+	TStringBuilder<128> activeNode;
+	if (const UBTNode* node = InTree.GetActiveNode())
+	{
+		node->GetFName().AppendString(activeNode);
+	}
+
+	UE_TRACE_LOG(ParallelBehavior, LayerTick, ParallelBehaviorChannel)
+		<< LayerTick.Cycle(InStartCycles)
+		<< LayerTick.DurationCycles(InCycles)
+		<< LayerTick.ManagerId(ParallelBehaviorTrace::GetManagerId(InManager))
+		<< LayerTick.LayerId(layerId.ToString(), layerId.Len())
+		<< LayerTick.ActiveNode(activeNode.ToString(), activeNode.Len());
+}
+
+void FParallelBehaviorTrace::OutputLayerLifetime(const UParallelBehaviorManagerComponent* InManager, const FName& InLayerId, bool bInAdded)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(ParallelBehaviorChannel))
+	{
+		return;
+	}
+
+	TRACE_OBJECT(InManager);
+	TStringBuilder<128> layerId;
+	InLayerId.AppendString(layerId);
+
+	UE_TRACE_LOG(ParallelBehavior, LayerLifetime, ParallelBehaviorChannel)
+		<< LayerLifetime.Cycle(FPlatformTime::Cycles64())
+		<< LayerLifetime.ManagerId(ParallelBehaviorTrace::GetManagerId(InManager))
+		<< LayerLifetime.LayerId(layerId.ToString(), layerId.Len())
+		<< LayerLifetime.bAdded(bInAdded);
+}
+
+#endif // PARALLEL_BEHAVIOR_TRACE_ENABLED
\ No newline at end of file
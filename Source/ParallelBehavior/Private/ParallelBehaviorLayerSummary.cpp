@@ -0,0 +1,25 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorLayerSummary.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+
+
+void FParallelBehaviorLayerSummaryItem::PreReplicatedRemove(const FParallelBehaviorLayerSummary& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+	{
+		InArraySerializer.Owner->OnLayerStateReplicated.Broadcast(Id, EParallelBehaviorLayerState::Inactive);
+	}
+}
+
+void FParallelBehaviorLayerSummaryItem::PostReplicatedAdd(const FParallelBehaviorLayerSummary& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+	{
+		InArraySerializer.Owner->OnLayerStateReplicated.Broadcast(Id, State);
+	}
+}
+
+void FParallelBehaviorLayerSummaryItem::PostReplicatedChange(const FParallelBehaviorLayerSummary& InArraySerializer)
+{
+	PostReplicatedAdd(InArraySerializer);
+}
\ No newline at end of file
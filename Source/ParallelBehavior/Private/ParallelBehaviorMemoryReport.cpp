@@ -0,0 +1,73 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehavior.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "Subsystems/ParallelBehaviorSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace ParallelBehaviorMemoryReport
+{
+	void LogStats(const TCHAR* InLabel, const FParallelBehaviorMemoryStats& InStats)
+	{
+		UE_LOG(LogParallelBehavior, Display,
+			TEXT("%-40s %5d layers %5d bb %4d pooled | total %8.1f KB: runtime %.1f, bb values %.1f, bt instance %.1f, components %.1f, pool %.1f, messages %.1f, registry %.1f"),
+			InLabel, InStats.NumLayers, InStats.NumBlackboards, InStats.NumPooledPairs,
+			InStats.GetTotalBytes() / 1024.0, InStats.RuntimeBytes / 1024.0, InStats.BlackboardValueBytes / 1024.0,
+			InStats.TreeInstanceBytes / 1024.0, InStats.ComponentBytes / 1024.0, InStats.PoolBytes / 1024.0,
+			InStats.MessageBytes / 1024.0, InStats.RegistryBytes / 1024.0);
+	}
+
+	void Run(const TArray<FString>& InArgs, UWorld* InWorld)
+	{
+		const UParallelBehaviorSubsystem* subsystem = InWorld != nullptr ? InWorld->GetSubsystem<UParallelBehaviorSubsystem>() : nullptr;
+		if (subsystem == nullptr)
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("pb.MemReport: Needs a game world"));
+			return;
+		}
+
+		// per manager lines, largest first, limited unless asked for all of them
+		int32 maxManagers = 20;
+		FParse::Value(*FString::Join(InArgs, TEXT(" ")), TEXT("Top="), maxManagers);
+
+		TArray<UParallelBehaviorManagerComponent*> managers;
+		subsystem->GetManagers(managers);
+
+		TArray<TPair<const UParallelBehaviorManagerComponent*, FParallelBehaviorMemoryStats>> entries;
+		entries.Reserve(managers.Num());
+		for (const UParallelBehaviorManagerComponent* manager : managers)
+		{
+			entries.Emplace(manager, manager->GetMemoryStats());
+		}
+		entries.Sort([](const auto& InA, const auto& InB)
+		{
+			return InA.Value.GetTotalBytes() > InB.Value.GetTotalBytes();
+		});
+
+		const int32 numLines = maxManagers > 0 ? FMath::Min(maxManagers, entries.Num()) : entries.Num();
+		for (int32 i = 0; i < numLines; ++i)
+		{
+			LogStats(*GetNameSafe(entries[i].Key->GetOwner()), entries[i].Value);
+		}
+
+		const FParallelBehaviorMemoryStats total = subsystem->GetMemoryStats();
+		LogStats(*FString::Printf(TEXT("Total (%d managers)"), managers.Num()), total);
+		if (managers.Num() > 0)
+		{
+			UE_LOG(LogParallelBehavior, Display, TEXT("pb.MemReport: %.1f KB per manager, %.1f KB per layer"),
+				total.GetTotalBytes() / 1024.0 / managers.Num(),
+				total.NumLayers > 0 ? total.GetTotalBytes() / 1024.0 / total.NumLayers : 0.0);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs MemReportCommand(
+		TEXT("pb.MemReport"),
+		TEXT("Logs the estimated memory of every parallel behavior manager of the world and the world total.\n")
+		TEXT("Usage: pb.MemReport [Top=20] (Top=0 lists every manager)"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&Run));
+}
+
+#endif // !UE_BUILD_SHIPPING
\ No newline at end of file
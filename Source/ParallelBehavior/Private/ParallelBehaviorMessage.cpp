@@ -0,0 +1,23 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorMessage.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+
+
+UParallelBehaviorManagerComponent* FParallelBehaviorLayerNodeMemory::Resolve(const UBehaviorTreeComponent& InTree)
+{
+	if (!LayerId.IsNone())
+	{
+		return Manager.Get();
+	}
+
+	// layer components are created with the manager as outer
+	UParallelBehaviorManagerComponent* manager = Cast<UParallelBehaviorManagerComponent>(InTree.GetOuter());
+	if (manager == nullptr)
+	{
+		return nullptr;
+	}
+
+	LayerId = manager->FindTreeId(&InTree);
+	Manager = manager;
+	return LayerId.IsNone() ? nullptr : manager;
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorSettings.h"
+
+
+UParallelBehaviorSettings::UParallelBehaviorSettings()
+{
+	SectionName = TEXT("Parallel Behavior");
+}
\ No newline at end of file
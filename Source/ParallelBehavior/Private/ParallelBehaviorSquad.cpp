@@ -0,0 +1,76 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "ParallelBehaviorSquad.h"
+#include "ParallelBehavior.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+
+
+bool UParallelBehaviorSquad::Initialize(const FName& InSquadId, UBlackboardData& InAsset)
+{
+	check(Blackboard == nullptr);
+
+	SquadId = InSquadId;
+
+	// not registered, the squad has no actor and the blackboard never ticks
+	Blackboard = NewObject<UBlackboardComponent>(this, TEXT("Squad_BlackboardComponent"));
+	if (!Blackboard->InitializeBlackboard(InAsset))
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("Initialize: Failed to initialize blackboard '%s' of squad '%s'"),
+			*InAsset.GetName(), *InSquadId.ToString());
+		return false;
+	}
+
+	const int32 numKeys = InAsset.GetNumKeys();
+	for (int32 i = 0; i < numKeys; ++i)
+	{
+		Blackboard->RegisterObserver(static_cast<FBlackboard::FKey>(i), this,
+			FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnKeyChanged));
+	}
+	return true;
+}
+
+void UParallelBehaviorSquad::Release()
+{
+	// LeaveSquad removes the member again, iterate a copy
+	const TArray<TWeakObjectPtr<UParallelBehaviorManagerComponent>> members = MoveTemp(Members);
+	for (const TWeakObjectPtr<UParallelBehaviorManagerComponent>& member : members)
+	{
+		if (UParallelBehaviorManagerComponent* manager = member.Get())
+		{
+			manager->LeaveSquad();
+		}
+	}
+	Members.Reset();
+
+	if (Blackboard != nullptr)
+	{
+		Blackboard->UnregisterObserversFrom(this);
+	}
+}
+
+void UParallelBehaviorSquad::AddMember(UParallelBehaviorManagerComponent* InManager)
+{
+	Members.AddUnique(InManager);
+}
+
+void UParallelBehaviorSquad::RemoveMember(UParallelBehaviorManagerComponent* InManager)
+{
+	Members.RemoveSingleSwap(InManager, EAllowShrinking::No);
+}
+
+EBlackboardNotificationResult UParallelBehaviorSquad::OnKeyChanged(const UBlackboardComponent& InBlackboard, FBlackboard::FKey InKey)
+{
+	for (int32 i = Members.Num() - 1; i >= 0; --i)
+	{
+		if (UParallelBehaviorManagerComponent* manager = Members[i].Get())
+		{
+			manager->MirrorSquadKey(InBlackboard, InKey);
+		}
+		else
+		{
+			Members.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		}
+	}
+	return EBlackboardNotificationResult::ContinueObserving;
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Processors/ParallelBehaviorProcessor.h"
+#include "ParallelBehavior.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+
+
+FParallelBehaviorFragmentView FParallelBehaviorFragmentView::Slice(int32 InStart, int32 InCount) const
+{
+	check(InStart >= 0 && InStart + InCount <= Count);
+
+	FParallelBehaviorFragmentView view;
+	view.Fragments = Fragments + InStart * Stride;
+	view.Stride = Stride;
+	view.Count = InCount;
+	view.Managers = Managers + InStart;
+	view.LayerIds = LayerIds + InStart;
+	view.Paused = Paused + InStart;
+	return view;
+}
+
+FParallelBehaviorProcessorBatch::~FParallelBehaviorProcessorBatch()
+{
+	Empty();
+}
+
+FParallelBehaviorProcessorHandle FParallelBehaviorProcessorBatch::Add(int32 InBatchIndex, UParallelBehaviorManagerComponent* InManager,
+	const FName& InLayerId, const FInstancedStruct& InInitialFragment)
+{
+	int32 slot;
+	if (FreeSlots.Num() > 0)
+	{
+		slot = FreeSlots.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		slot = SlotToIndex.Add(INDEX_NONE);
+		SlotSerials.Add(1);
+	}
+
+	const int32 index = LayerIds.Add(InLayerId);
+	Managers.Add(InManager);
+	Paused.Add(false);
+	IndexToSlot.Add(slot);
+	SlotToIndex[slot] = index;
+
+	Fragments.AddUninitialized(Stride);
+	uint8* fragment = GetFragment(index);
+	FragmentType->InitializeStruct(fragment);
+	if (InInitialFragment.GetScriptStruct() == FragmentType)
+	{
+		FragmentType->CopyScriptStruct(fragment, InInitialFragment.GetMemory());
+	}
+	else if (InInitialFragment.IsValid())
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("Add: Initial fragment '%s' of layer '%s' does not match processor fragment '%s', using defaults"),
+			*GetNameSafe(InInitialFragment.GetScriptStruct()), *InLayerId.ToString(), *FragmentType->GetName());
+	}
+
+	FParallelBehaviorProcessorHandle handle;
+	handle.Batch = InBatchIndex;
+	handle.Slot = slot;
+	handle.Serial = SlotSerials[slot];
+	return handle;
+}
+
+bool FParallelBehaviorProcessorBatch::Remove(const FParallelBehaviorProcessorHandle& InHandle)
+{
+	const int32 index = IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	RemoveAt(index);
+	return true;
+}
+
+void FParallelBehaviorProcessorBatch::RemoveAt(int32 InIndex)
+{
+	const int32 slot = IndexToSlot[InIndex];
+	const int32 lastIndex = Num() - 1;
+
+	FragmentType->DestroyStruct(GetFragment(InIndex));
+	if (InIndex != lastIndex)
+	{
+		// relocate the last fragment into the freed index, the old bytes are dropped without destruction
+		FMemory::Memcpy(GetFragment(InIndex), GetFragment(lastIndex), Stride);
+		SlotToIndex[IndexToSlot[lastIndex]] = InIndex;
+	}
+	Fragments.RemoveAt(lastIndex * Stride, Stride, EAllowShrinking::No);
+
+	LayerIds.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	Managers.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	Paused.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	IndexToSlot.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+
+	SlotToIndex[slot] = INDEX_NONE;
+	++SlotSerials[slot];
+	FreeSlots.Add(slot);
+}
+
+int32 FParallelBehaviorProcessorBatch::IndexOf(const FParallelBehaviorProcessorHandle& InHandle) const
+{
+	if (!SlotToIndex.IsValidIndex(InHandle.Slot) || SlotSerials[InHandle.Slot] != InHandle.Serial)
+	{
+		return INDEX_NONE;
+	}
+	return SlotToIndex[InHandle.Slot];
+}
+
+FParallelBehaviorFragmentView FParallelBehaviorProcessorBatch::MakeView() const
+{
+	FParallelBehaviorFragmentView view;
+	view.Fragments = const_cast<uint8*>(Fragments.GetData());
+	view.Stride = Stride;
+	view.Count = Num();
+	view.Managers = Managers.GetData();
+	view.LayerIds = LayerIds.GetData();
+	view.Paused = Paused.GetData();
+	return view;
+}
+
+FParallelBehaviorFragmentView FParallelBehaviorProcessorBatch::MakeView(int32 InIndex) const
+{
+	return MakeView().Slice(InIndex, 1);
+}
+
+void FParallelBehaviorProcessorBatch::Empty()
+{
+	if (FragmentType != nullptr)
+	{
+		for (int32 i = 0; i < Num(); ++i)
+		{
+			FragmentType->DestroyStruct(GetFragment(i));
+		}
+	}
+	Fragments.Empty();
+	LayerIds.Empty();
+	Managers.Empty();
+	Paused.Empty();
+	IndexToSlot.Empty();
+
+	// keep serials so handles issued before stay stale
+	FreeSlots.Reset();
+	for (int32 i = 0; i < SlotToIndex.Num(); ++i)
+	{
+		if (SlotToIndex[i] != INDEX_NONE)
+		{
+			SlotToIndex[i] = INDEX_NONE;
+			++SlotSerials[i];
+		}
+		FreeSlots.Add(i);
+	}
+}
+
+void FParallelBehaviorProcessorBatch::AddReferencedObjects(FReferenceCollector& Collector, const UObject* InReferencer)
+{
+	Collector.AddReferencedObject(Processor, InReferencer);
+	Collector.AddReferencedObject(FragmentType, InReferencer);
+	if (FragmentType == nullptr)
+	{
+		return;
+	}
+
+	// fragments are raw bytes to the GC, walk the reference properties of each one
+	for (int32 i = 0; i < Num(); ++i)
+	{
+		Collector.AddPropertyReferencesWithStructARO(FragmentType, GetFragment(i), InReferencer);
+	}
+}
+
+SIZE_T FParallelBehaviorProcessorBatch::GetAllocatedSize() const
+{
+	return Fragments.GetAllocatedSize() + Managers.GetAllocatedSize() + LayerIds.GetAllocatedSize() + Paused.GetAllocatedSize()
+		+ SlotToIndex.GetAllocatedSize() + SlotSerials.GetAllocatedSize() + IndexToSlot.GetAllocatedSize() + FreeSlots.GetAllocatedSize();
+}
\ No newline at end of file
@@ -0,0 +1,1153 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Subsystems/ParallelBehaviorSubsystem.h"
+#include "ParallelBehavior.h"
+#include "ParallelBehaviorSettings.h"
+#include "ParallelBehaviorSquad.h"
+#include "ParallelBehaviorStats.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "Conditions/ParallelBehaviorTickCondition.h"
+
+#include "Async/ParallelFor.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "GameFramework/PlayerController.h"
+
+
+FParallelBehaviorLayerHandle FParallelBehaviorLayerRegistry::Add(UParallelBehaviorManagerComponent* InAgent, const FName& InLayerId,
+	UBehaviorTreeComponent* InTreeComponent, UBlackboardComponent* InBlackboard)
+{
+	int32 slot;
+	if (FreeSlots.Num() > 0)
+	{
+		slot = FreeSlots.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		slot = SlotToIndex.Add(INDEX_NONE);
+		SlotSerials.Add(1);
+	}
+
+	const int32 index = LayerIds.Add(InLayerId);
+	Agents.Add(InAgent);
+	TreeComponents.Add(InTreeComponent);
+	Blackboards.Add(InBlackboard);
+	Flags.Add(EParallelBehaviorLayerFlags::None);
+	Priorities.Add(0);
+	TickIntervals.Add(0.0f);
+	LastTickTimes.Add(0.0);
+	NextTickTimes.Add(0.0);
+	TickConditions.AddDefaulted();
+	TickConditionKeys.AddDefaulted();
+	TickCounts.Add(0);
+	LastTickCycles.Add(0);
+	TotalTickCycles.Add(0);
+#if STATS
+	StatIds.AddDefaulted();
+#endif
+#if PARALLEL_BEHAVIOR_DEBUG
+	TickHistories.AddDefaulted();
+#endif
+	IndexToSlot.Add(slot);
+	SlotToIndex[slot] = index;
+
+	FParallelBehaviorLayerHandle handle;
+	handle.Slot = slot;
+	handle.Serial = SlotSerials[slot];
+	return handle;
+}
+
+bool FParallelBehaviorLayerRegistry::Remove(const FParallelBehaviorLayerHandle& InHandle)
+{
+	const int32 index = IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	RemoveAt(index);
+	return true;
+}
+
+void FParallelBehaviorLayerRegistry::RemoveAt(int32 InIndex)
+{
+	const int32 slot = IndexToSlot[InIndex];
+	const int32 lastIndex = Num() - 1;
+
+	Agents.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	LayerIds.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	TreeComponents.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	Blackboards.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	Flags.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	Priorities.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	TickIntervals.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	LastTickTimes.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	NextTickTimes.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	TickConditions.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	TickConditionKeys.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	TickCounts.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	LastTickCycles.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+	TotalTickCycles.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+#if STATS
+	StatIds.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+#endif
+#if PARALLEL_BEHAVIOR_DEBUG
+	TickHistories.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+#endif
+	IndexToSlot.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+
+	if (InIndex != lastIndex)
+	{
+		// the last layer now lives in the freed index
+		SlotToIndex[IndexToSlot[InIndex]] = InIndex;
+	}
+
+	SlotToIndex[slot] = INDEX_NONE;
+	++SlotSerials[slot];
+	FreeSlots.Add(slot);
+}
+
+int32 FParallelBehaviorLayerRegistry::IndexOf(const FParallelBehaviorLayerHandle& InHandle) const
+{
+	if (!SlotToIndex.IsValidIndex(InHandle.Slot) || SlotSerials[InHandle.Slot] != InHandle.Serial)
+	{
+		return INDEX_NONE;
+	}
+	return SlotToIndex[InHandle.Slot];
+}
+
+FParallelBehaviorLayerHandle FParallelBehaviorLayerRegistry::GetHandle(int32 InIndex) const
+{
+	FParallelBehaviorLayerHandle handle;
+	handle.Slot = IndexToSlot[InIndex];
+	handle.Serial = SlotSerials[handle.Slot];
+	return handle;
+}
+
+SIZE_T FParallelBehaviorLayerRegistry::GetAllocatedSize() const
+{
+	SIZE_T bytes = Agents.GetAllocatedSize() + LayerIds.GetAllocatedSize() + TreeComponents.GetAllocatedSize()
+		+ Blackboards.GetAllocatedSize() + Flags.GetAllocatedSize() + Priorities.GetAllocatedSize()
+		+ TickIntervals.GetAllocatedSize() + LastTickTimes.GetAllocatedSize() + NextTickTimes.GetAllocatedSize()
+		+ TickConditions.GetAllocatedSize() + TickConditionKeys.GetAllocatedSize() + TickCounts.GetAllocatedSize()
+		+ LastTickCycles.GetAllocatedSize() + TotalTickCycles.GetAllocatedSize()
+		+ SlotToIndex.GetAllocatedSize() + SlotSerials.GetAllocatedSize() + IndexToSlot.GetAllocatedSize() + FreeSlots.GetAllocatedSize();
+	for (const TArray<FBlackboard::FKey>& keys : TickConditionKeys)
+	{
+		bytes += keys.GetAllocatedSize();
+	}
+#if STATS
+	bytes += StatIds.GetAllocatedSize();
+#endif
+#if PARALLEL_BEHAVIOR_DEBUG
+	bytes += TickHistories.GetAllocatedSize();
+#endif
+	return bytes;
+}
+
+void FParallelBehaviorLayerRegistry::Empty()
+{
+	Agents.Empty();
+	LayerIds.Empty();
+	TreeComponents.Empty();
+	Blackboards.Empty();
+	Flags.Empty();
+	Priorities.Empty();
+	TickIntervals.Empty();
+	LastTickTimes.Empty();
+	NextTickTimes.Empty();
+	TickConditions.Empty();
+	TickConditionKeys.Empty();
+	TickCounts.Empty();
+	LastTickCycles.Empty();
+	TotalTickCycles.Empty();
+#if STATS
+	StatIds.Empty();
+#endif
+#if PARALLEL_BEHAVIOR_DEBUG
+	TickHistories.Empty();
+#endif
+	IndexToSlot.Empty();
+
+	// keep serials so handles issued before stay stale
+	FreeSlots.Reset();
+	for (int32 i = 0; i < SlotToIndex.Num(); ++i)
+	{
+		if (SlotToIndex[i] != INDEX_NONE)
+		{
+			SlotToIndex[i] = INDEX_NONE;
+			++SlotSerials[i];
+		}
+		FreeSlots.Add(i);
+	}
+}
+
+void UParallelBehaviorSubsystem::RegisterManager(UParallelBehaviorManagerComponent* InManager)
+{
+	if (InManager != nullptr)
+	{
+		Managers.AddUnique(InManager);
+	}
+}
+
+void UParallelBehaviorSubsystem::UnregisterManager(UParallelBehaviorManagerComponent* InManager)
+{
+	Managers.RemoveSwap(InManager, EAllowShrinking::No);
+}
+
+void UParallelBehaviorSubsystem::EnqueueSpawn(UParallelBehaviorManagerComponent* InManager, const FParallelBehaviorSetup& InSetup)
+{
+	FParallelBehaviorSpawnRequest& request = SpawnQueue.AddDefaulted_GetRef();
+	request.Manager = InManager;
+	request.Setup = InSetup;
+	request.Sequence = NextSpawnSequence++;
+	bSpawnQueueDirty = true;
+}
+
+int32 UParallelBehaviorSubsystem::CancelSpawns(const UParallelBehaviorManagerComponent* InManager)
+{
+	// RemoveAll keeps the order, the queue stays sorted
+	return SpawnQueue.RemoveAll([InManager](const FParallelBehaviorSpawnRequest& InRequest)
+	{
+		return InRequest.Manager.Get() == InManager;
+	});
+}
+
+FParallelBehaviorLayerHandle UParallelBehaviorSubsystem::RegisterLayer(UParallelBehaviorManagerComponent* InManager,
+	const FName& InLayerId, UBehaviorTreeComponent* InTreeComponent, UBlackboardComponent* InBlackboard)
+{
+	const FParallelBehaviorLayerHandle handle = Layers.Add(InManager, InLayerId, InTreeComponent, InBlackboard);
+
+#if STATS
+	// generated Ids only differ by their number, group them under the asset name
+	const FName statName(InLayerId, 0);
+	TStatId* statId = LayerStatIds.Find(statName);
+	if (statId == nullptr)
+	{
+		statId = &LayerStatIds.Add(statName,
+			FDynamicStats::CreateStatId<FStatGroup_STATGROUP_ParallelBehavior>(FString::Printf(TEXT("Layer %s"), *statName.ToString())));
+	}
+	Layers.StatIds[Layers.IndexOf(handle)] = *statId;
+#endif
+
+	PARALLEL_BEHAVIOR_TRACE_LAYER_LIFETIME(InManager, InLayerId, true);
+	return handle;
+}
+
+void UParallelBehaviorSubsystem::UnregisterLayer(FParallelBehaviorLayerHandle& InOutHandle)
+{
+#if PARALLEL_BEHAVIOR_TRACE_ENABLED
+	const int32 index = Layers.IndexOf(InOutHandle);
+	if (index != INDEX_NONE)
+	{
+		PARALLEL_BEHAVIOR_TRACE_LAYER_LIFETIME(Layers.Agents[index].Get(), Layers.LayerIds[index], false);
+	}
+#endif
+	Layers.Remove(InOutHandle);
+	InOutHandle.Reset();
+}
+
+void UParallelBehaviorSubsystem::SetLayerManagedTick(const FParallelBehaviorLayerHandle& InHandle, float InTickInterval,
+	int32 InPriority, bool bInRandomPhase)
+{
+	const int32 index = Layers.IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return;
+	}
+
+	const double now = GetSchedulerTime();
+	const float interval = FMath::Max(InTickInterval, 0.0f);
+
+	Layers.Flags[index] |= EParallelBehaviorLayerFlags::ManagedTick;
+	Layers.TickIntervals[index] = interval;
+	Layers.Priorities[index] = InPriority;
+	Layers.LastTickTimes[index] = now;
+	const float phase = bInRandomPhase ? (bStepMode ? StepRandom.FRand() : FMath::FRand()) : 0.0f;
+	Layers.NextTickTimes[index] = now + phase * interval;
+}
+
+bool UParallelBehaviorSubsystem::SetLayerTickSettings(const FParallelBehaviorLayerHandle& InHandle, float InTickInterval,
+	int32 InPriority)
+{
+	const int32 index = Layers.IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Layers.TickIntervals[index] = FMath::Max(InTickInterval, 0.0f);
+	Layers.Priorities[index] = InPriority;
+	Layers.NextTickTimes[index] = FMath::Min(Layers.NextTickTimes[index], Layers.LastTickTimes[index] + Layers.TickIntervals[index]);
+	return true;
+}
+
+float UParallelBehaviorSubsystem::GetLayerTickInterval(const FParallelBehaviorLayerHandle& InHandle) const
+{
+	const int32 index = Layers.IndexOf(InHandle);
+	return index != INDEX_NONE ? Layers.TickIntervals[index] : 0.0f;
+}
+
+bool UParallelBehaviorSubsystem::SetLayerTickCondition(const FParallelBehaviorLayerHandle& InHandle,
+	const UParallelBehaviorTickCondition* InCondition, bool bInThreadSafe)
+{
+	const int32 index = Layers.IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Layers.TickConditions[index] = InCondition;
+	Layers.TickConditionKeys[index].Reset();
+
+	const UBlackboardComponent* blackboard = Layers.Blackboards[index].Get();
+	const UBlackboardData* blackboardAsset = blackboard != nullptr ? blackboard->GetBlackboardAsset() : nullptr;
+	if (InCondition != nullptr && blackboardAsset != nullptr)
+	{
+		InCondition->ResolveKeys(*blackboardAsset, Layers.TickConditionKeys[index]);
+	}
+
+	if (InCondition != nullptr && bInThreadSafe)
+	{
+		Layers.Flags[index] |= EParallelBehaviorLayerFlags::ThreadSafe;
+	}
+	else
+	{
+		Layers.Flags[index] &= ~EParallelBehaviorLayerFlags::ThreadSafe;
+	}
+	return true;
+}
+
+bool UParallelBehaviorSubsystem::SetLayerPaused(const FParallelBehaviorLayerHandle& InHandle, bool bInPaused)
+{
+	return SetLayerHoldFlag(InHandle, EParallelBehaviorLayerFlags::Paused, bInPaused);
+}
+
+bool UParallelBehaviorSubsystem::SetLayerSleeping(const FParallelBehaviorLayerHandle& InHandle, bool bInSleeping)
+{
+	return SetLayerHoldFlag(InHandle, EParallelBehaviorLayerFlags::Sleeping, bInSleeping);
+}
+
+bool UParallelBehaviorSubsystem::SetLayerHoldFlag(const FParallelBehaviorLayerHandle& InHandle, EParallelBehaviorLayerFlags InFlag,
+	bool bInSet)
+{
+	const int32 index = Layers.IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	constexpr EParallelBehaviorLayerFlags holdFlags = EParallelBehaviorLayerFlags::Paused | EParallelBehaviorLayerFlags::Sleeping;
+	EParallelBehaviorLayerFlags& flags = Layers.Flags[index];
+	const bool bWasHeld = EnumHasAnyFlags(flags, holdFlags);
+
+	if (bInSet)
+	{
+		flags |= InFlag;
+	}
+	else
+	{
+		flags &= ~InFlag;
+	}
+
+	if (bWasHeld && !EnumHasAnyFlags(flags, holdFlags))
+	{
+		// time spent paused must not be handed to the tree as one huge delta
+		const double now = GetSchedulerTime();
+		Layers.LastTickTimes[index] = now;
+		Layers.NextTickTimes[index] = FMath::Min(Layers.NextTickTimes[index], now);
+	}
+	return true;
+}
+
+void UParallelBehaviorSubsystem::SetWorldPaused(bool bInPaused)
+{
+	if (bWorldPaused == bInPaused)
+	{
+		return;
+	}
+
+	bWorldPaused = bInPaused;
+	for (int32 i = Managers.Num() - 1; i >= 0; --i)
+	{
+		if (UParallelBehaviorManagerComponent* manager = Managers[i].Get())
+		{
+			manager->SetPausedByWorld(bInPaused);
+		}
+		else
+		{
+			Managers.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+void UParallelBehaviorSubsystem::TeardownAllManagers()
+{
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_RemoveTree);
+
+	// one reset instead of a queue scan per manager
+	SpawnQueue.Reset();
+	bSpawnQueueDirty = false;
+
+	TArray<UParallelBehaviorManagerComponent*> managers;
+	GetManagers(managers);
+	for (UParallelBehaviorManagerComponent* manager : managers)
+	{
+		manager->CancelQueuedTrees();
+		manager->TeardownTrees();
+	}
+}
+
+void UParallelBehaviorSubsystem::DeferDestroy(UActorComponent* InComponent)
+{
+	if (!IsValid(InComponent))
+	{
+		return;
+	}
+
+	InComponent->SetComponentTickEnabled(false);
+	PendingDestroys.Add(InComponent);
+}
+
+void UParallelBehaviorSubsystem::ProcessPendingDestroys()
+{
+	if (PendingDestroys.Num() == 0)
+	{
+		return;
+	}
+
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_RemoveTree);
+
+	const int32 maxDestroys = GetDefault<UParallelBehaviorSettings>()->MaxComponentDestroysPerFrame;
+	const int32 numDestroys = maxDestroys > 0 ? FMath::Min(maxDestroys, PendingDestroys.Num()) : PendingDestroys.Num();
+	for (int32 i = 0; i < numDestroys; ++i)
+	{
+		if (UActorComponent* component = PendingDestroys[i].Get(); IsValid(component))
+		{
+			component->DestroyComponent();
+		}
+	}
+	PendingDestroys.RemoveAt(0, numDestroys, EAllowShrinking::No);
+}
+
+bool UParallelBehaviorSubsystem::GetLayerStats(const FParallelBehaviorLayerHandle& InHandle, FParallelBehaviorLayerStats& OutStats) const
+{
+	const int32 index = Layers.IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const uint32 tickCount = Layers.TickCounts[index];
+	const double totalMs = FPlatformTime::ToMilliseconds64(Layers.TotalTickCycles[index]);
+	OutStats.TickCount = static_cast<int32>(tickCount);
+	OutStats.LastTickMs = static_cast<float>(FPlatformTime::ToMilliseconds64(Layers.LastTickCycles[index]));
+	OutStats.TotalTickMs = static_cast<float>(totalMs);
+	OutStats.AverageTickMs = tickCount > 0 ? static_cast<float>(totalMs / tickCount) : 0.0f;
+	return true;
+}
+
+#if PARALLEL_BEHAVIOR_DEBUG
+const FParallelBehaviorTickHistory* UParallelBehaviorSubsystem::GetLayerTickHistory(const FParallelBehaviorLayerHandle& InHandle) const
+{
+	const int32 index = Layers.IndexOf(InHandle);
+	return index != INDEX_NONE ? &Layers.TickHistories[index] : nullptr;
+}
+#endif
+
+int32 UParallelBehaviorSubsystem::CountLayers(EParallelBehaviorLayerFlags InFlags) const
+{
+	int32 count = 0;
+	for (const EParallelBehaviorLayerFlags flags : Layers.Flags)
+	{
+		count += EnumHasAllFlags(flags, InFlags) ? 1 : 0;
+	}
+	return count;
+}
+
+FParallelBehaviorProcessorHandle UParallelBehaviorSubsystem::AddProcessorLayer(UParallelBehaviorManagerComponent* InManager,
+	const FName& InLayerId, TSubclassOf<UParallelBehaviorProcessor> InProcessor, const FInstancedStruct& InInitialFragment)
+{
+	const UParallelBehaviorProcessor* processor = InProcessor != nullptr ? InProcessor->GetDefaultObject<UParallelBehaviorProcessor>() : nullptr;
+	const UScriptStruct* fragmentType = processor != nullptr ? processor->GetFragmentType() : nullptr;
+	if (fragmentType == nullptr)
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("AddProcessorLayer: Processor '%s' of layer '%s' has no fragment type"),
+			*GetNameSafe(InProcessor), *InLayerId.ToString());
+		return FParallelBehaviorProcessorHandle();
+	}
+
+	int32 batchIndex;
+	if (const int32* existing = ProcessorBatchByClass.Find(InProcessor.Get()))
+	{
+		batchIndex = *existing;
+	}
+	else
+	{
+		if (fragmentType->GetMinAlignment() > 16)
+		{
+			UE_LOG(LogParallelBehavior, Warning, TEXT("AddProcessorLayer: Fragment '%s' needs more than 16 byte alignment"), *fragmentType->GetName());
+			return FParallelBehaviorProcessorHandle();
+		}
+
+		batchIndex = ProcessorBatches.AddDefaulted();
+		FParallelBehaviorProcessorBatch& batch = ProcessorBatches[batchIndex];
+		batch.Processor = processor;
+		batch.FragmentType = fragmentType;
+		batch.Stride = Align(fragmentType->GetStructureSize(), fragmentType->GetMinAlignment());
+		ProcessorBatchByClass.Add(InProcessor.Get(), batchIndex);
+	}
+
+	FParallelBehaviorProcessorBatch& batch = ProcessorBatches[batchIndex];
+	const FParallelBehaviorProcessorHandle handle = batch.Add(batchIndex, InManager, InLayerId, InInitialFragment);
+	const int32 index = batch.IndexOf(handle);
+	if (index != INDEX_NONE)
+	{
+		batch.Processor->InitializeFragment(batch.MakeView(index));
+	}
+	return handle;
+}
+
+void UParallelBehaviorSubsystem::RemoveProcessorLayer(FParallelBehaviorProcessorHandle& InOutHandle)
+{
+	if (ProcessorBatches.IsValidIndex(InOutHandle.Batch))
+	{
+		ProcessorBatches[InOutHandle.Batch].Remove(InOutHandle);
+	}
+	InOutHandle.Reset();
+}
+
+bool UParallelBehaviorSubsystem::SetProcessorLayerPaused(const FParallelBehaviorProcessorHandle& InHandle, bool bInPaused)
+{
+	if (!ProcessorBatches.IsValidIndex(InHandle.Batch))
+	{
+		return false;
+	}
+
+	FParallelBehaviorProcessorBatch& batch = ProcessorBatches[InHandle.Batch];
+	const int32 index = batch.IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	batch.Paused[index] = bInPaused;
+	return true;
+}
+
+bool UParallelBehaviorSubsystem::IsProcessorLayerPaused(const FParallelBehaviorProcessorHandle& InHandle) const
+{
+	if (!ProcessorBatches.IsValidIndex(InHandle.Batch))
+	{
+		return false;
+	}
+
+	const FParallelBehaviorProcessorBatch& batch = ProcessorBatches[InHandle.Batch];
+	const int32 index = batch.IndexOf(InHandle);
+	return index != INDEX_NONE && batch.Paused[index];
+}
+
+uint8* UParallelBehaviorSubsystem::GetProcessorFragment(const FParallelBehaviorProcessorHandle& InHandle, const UScriptStruct*& OutType)
+{
+	OutType = nullptr;
+	if (!ProcessorBatches.IsValidIndex(InHandle.Batch))
+	{
+		return nullptr;
+	}
+
+	FParallelBehaviorProcessorBatch& batch = ProcessorBatches[InHandle.Batch];
+	const int32 index = batch.IndexOf(InHandle);
+	if (index == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	OutType = batch.FragmentType;
+	return batch.GetFragment(index);
+}
+
+const FParallelBehaviorProcessorBatch* UParallelBehaviorSubsystem::GetProcessorBatch(const FParallelBehaviorProcessorHandle& InHandle) const
+{
+	if (!ProcessorBatches.IsValidIndex(InHandle.Batch) || ProcessorBatches[InHandle.Batch].IndexOf(InHandle) == INDEX_NONE)
+	{
+		return nullptr;
+	}
+	return &ProcessorBatches[InHandle.Batch];
+}
+
+UParallelBehaviorSquad* UParallelBehaviorSubsystem::FindOrCreateSquad(FName InSquadId, UBlackboardData* InBlackboardAsset)
+{
+	if (InSquadId.IsNone())
+	{
+		return nullptr;
+	}
+	if (UParallelBehaviorSquad* squad = FindSquad(InSquadId))
+	{
+		return squad;
+	}
+	if (InBlackboardAsset == nullptr)
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("FindOrCreateSquad: Squad '%s' does not exist and no blackboard asset was given"),
+			*InSquadId.ToString());
+		return nullptr;
+	}
+
+	UParallelBehaviorSquad* squad = NewObject<UParallelBehaviorSquad>(this);
+	if (!squad->Initialize(InSquadId, *InBlackboardAsset))
+	{
+		return nullptr;
+	}
+	Squads.Add(InSquadId, squad);
+	return squad;
+}
+
+UParallelBehaviorSquad* UParallelBehaviorSubsystem::FindSquad(FName InSquadId) const
+{
+	const TObjectPtr<UParallelBehaviorSquad>* squad = Squads.Find(InSquadId);
+	return squad != nullptr ? squad->Get() : nullptr;
+}
+
+void UParallelBehaviorSubsystem::RemoveSquad(FName InSquadId)
+{
+	TObjectPtr<UParallelBehaviorSquad> squad;
+	if (Squads.RemoveAndCopyValue(InSquadId, squad) && squad != nullptr)
+	{
+		squad->Release();
+	}
+}
+
+void UParallelBehaviorSubsystem::StoreSnapshot(const FName& InKey, FParallelBehaviorSnapshot&& InSnapshot)
+{
+	if (InKey.IsNone())
+	{
+		return;
+	}
+	StoredSnapshots.Add(InKey, MoveTemp(InSnapshot));
+}
+
+bool UParallelBehaviorSubsystem::TakeSnapshot(const FName& InKey, FParallelBehaviorSnapshot& OutSnapshot)
+{
+	return StoredSnapshots.RemoveAndCopyValue(InKey, OutSnapshot);
+}
+
+int32 UParallelBehaviorSubsystem::GetNumProcessorLayers() const
+{
+	int32 count = 0;
+	for (const FParallelBehaviorProcessorBatch& batch : ProcessorBatches)
+	{
+		count += batch.Num();
+	}
+	return count;
+}
+
+FParallelBehaviorMemoryStats UParallelBehaviorSubsystem::GetMemoryStats() const
+{
+	FParallelBehaviorMemoryStats stats;
+	for (const TWeakObjectPtr<UParallelBehaviorManagerComponent>& manager : Managers)
+	{
+		if (const UParallelBehaviorManagerComponent* managerPtr = manager.Get())
+		{
+			stats += managerPtr->GetMemoryStats();
+		}
+	}
+	stats.RegistryBytes = Layers.GetAllocatedSize() + Managers.GetAllocatedSize()
+		+ ProcessorBatches.GetAllocatedSize() + ProcessorBatchByClass.GetAllocatedSize();
+	for (const FParallelBehaviorProcessorBatch& batch : ProcessorBatches)
+	{
+		stats.RegistryBytes += batch.GetAllocatedSize();
+	}
+	return stats;
+}
+
+void UParallelBehaviorSubsystem::GetManagers(TArray<UParallelBehaviorManagerComponent*>& OutManagers) const
+{
+	OutManagers.Reset(Managers.Num());
+	for (const TWeakObjectPtr<UParallelBehaviorManagerComponent>& manager : Managers)
+	{
+		if (UParallelBehaviorManagerComponent* managerPtr = manager.Get())
+		{
+			OutManagers.Add(managerPtr);
+		}
+	}
+}
+
+void UParallelBehaviorSubsystem::Deinitialize()
+{
+	Layers.Empty();
+	Managers.Empty();
+	SpawnQueue.Empty();
+	StoredSnapshots.Empty();
+	for (const TPair<FName, TObjectPtr<UParallelBehaviorSquad>>& squad : Squads)
+	{
+		squad.Value->Release();
+	}
+	Squads.Empty();
+	PendingDestroys.Empty(); // world cleanup takes the components along
+	ProcessorBatches.Empty();
+	ProcessorBatchByClass.Empty();
+	Super::Deinitialize();
+}
+
+void UParallelBehaviorSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UParallelBehaviorSubsystem* subsystem = CastChecked<UParallelBehaviorSubsystem>(InThis);
+	for (FParallelBehaviorProcessorBatch& batch : subsystem->ProcessorBatches)
+	{
+		batch.AddReferencedObjects(Collector, subsystem);
+	}
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UParallelBehaviorSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const UParallelBehaviorSettings* settings = GetDefault<UParallelBehaviorSettings>();
+	if (settings->bStepMode)
+	{
+		SetStepMode(true, settings->StepRandomSeed);
+	}
+}
+
+void UParallelBehaviorSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double now = GetWorld()->GetTimeSeconds();
+	if (now >= NextLODUpdateTime)
+	{
+		NextLODUpdateTime = now + GetDefault<UParallelBehaviorSettings>()->LODUpdateInterval;
+		UpdateLODs();
+	}
+
+	ProcessSpawnQueue();
+	ProcessPendingDestroys();
+	if (!bStepMode)
+	{
+		TickManagedLayers(now);
+		TickProcessors(now, DeltaTime);
+	}
+
+	SET_DWORD_STAT(STAT_ParallelBehavior_ActiveTrees, Layers.Num());
+	SET_DWORD_STAT(STAT_ParallelBehavior_DeferredTicks, LastDeferredTicks);
+	SET_DWORD_STAT(STAT_ParallelBehavior_SkippedTicks, LastSkippedTicks);
+	SET_DWORD_STAT(STAT_ParallelBehavior_ProcessorLayers, GetNumProcessorLayers());
+}
+
+double UParallelBehaviorSubsystem::GetSchedulerTime() const
+{
+	return bStepMode ? StepTime : GetWorld()->GetTimeSeconds();
+}
+
+void UParallelBehaviorSubsystem::SetStepMode(bool bInEnabled, int32 InRandomSeed)
+{
+	if (bStepMode == bInEnabled)
+	{
+		return;
+	}
+
+	// rebase the schedule onto the clock taking over, so no layer sees a jump in its delta time
+	const double worldTime = GetWorld()->GetTimeSeconds();
+	const double offset = bInEnabled ? 0.0 : worldTime - StepTime;
+	StepTime = worldTime;
+	bStepMode = bInEnabled;
+	StepRandom.Initialize(InRandomSeed);
+
+	if (offset != 0.0)
+	{
+		for (int32 i = 0; i < Layers.Num(); ++i)
+		{
+			Layers.LastTickTimes[i] += offset;
+			Layers.NextTickTimes[i] += offset;
+		}
+		for (FParallelBehaviorProcessorBatch& batch : ProcessorBatches)
+		{
+			batch.LastTickTime = batch.LastTickTime >= 0.0 ? batch.LastTickTime + offset : batch.LastTickTime;
+			batch.NextTickTime += offset;
+		}
+	}
+
+	if (bInEnabled)
+	{
+		TArray<UParallelBehaviorManagerComponent*> managers;
+		GetManagers(managers);
+		for (UParallelBehaviorManagerComponent* manager : managers)
+		{
+			manager->UseManagedTickForAllTrees();
+		}
+	}
+}
+
+void UParallelBehaviorSubsystem::StepAll(float DeltaTime)
+{
+	if (!bStepMode)
+	{
+		UE_LOG(LogParallelBehavior, Warning, TEXT("StepAll: Step mode is off, layers advance with the world"));
+		return;
+	}
+
+	StepTime += FMath::Max(DeltaTime, 0.0f);
+	// never the time budget, a step ticks the same layers on every machine
+	TickManagedLayers(StepTime, FMath::Max(GetDefault<UParallelBehaviorSettings>()->MaxLayerTicksPerStep, 0), false);
+	TickProcessors(StepTime, DeltaTime);
+
+	SET_DWORD_STAT(STAT_ParallelBehavior_DeferredTicks, LastDeferredTicks);
+	SET_DWORD_STAT(STAT_ParallelBehavior_SkippedTicks, LastSkippedTicks);
+}
+
+void UParallelBehaviorSubsystem::TickProcessors(double InNow, float InFirstDeltaTime)
+{
+	if (bWorldPaused || ProcessorBatches.Num() == 0)
+	{
+		return;
+	}
+
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_Processors);
+
+	UWorld* world = GetWorld();
+	const double now = InNow;
+	for (FParallelBehaviorProcessorBatch& batch : ProcessorBatches)
+	{
+		if (batch.Num() == 0 || now < batch.NextTickTime)
+		{
+			continue;
+		}
+
+		const UParallelBehaviorProcessor* processor = batch.Processor;
+		FParallelBehaviorProcessorContext context;
+		context.World = world;
+		context.Time = now;
+		context.DeltaTime = batch.LastTickTime >= 0.0 ? static_cast<float>(now - batch.LastTickTime) : InFirstDeltaTime;
+		batch.LastTickTime = now;
+		batch.NextTickTime = now + processor->TickInterval;
+
+		const FParallelBehaviorFragmentView view = batch.MakeView();
+		const int32 batchSize = FMath::Max(processor->BatchSize, 1);
+		if (processor->bThreadSafe && view.Num() > batchSize)
+		{
+			const int32 numRanges = FMath::DivideAndRoundUp(view.Num(), batchSize);
+			ParallelFor(numRanges, [processor, &context, &view, batchSize](int32 InRange)
+			{
+				const int32 start = InRange * batchSize;
+				processor->Execute(context, view.Slice(start, FMath::Min(batchSize, view.Num() - start)));
+			});
+		}
+		else
+		{
+			processor->Execute(context, view);
+		}
+	}
+}
+
+void UParallelBehaviorSubsystem::ProcessSpawnQueue()
+{
+	if (SpawnQueue.Num() == 0)
+	{
+		return;
+	}
+
+	const UParallelBehaviorSettings* settings = GetDefault<UParallelBehaviorSettings>();
+	const int32 maxSpawns = settings->MaxSpawnsPerFrame > 0 ? settings->MaxSpawnsPerFrame : TNumericLimits<int32>::Max();
+	const double budgetSeconds = settings->SpawnBudgetMs > 0.0f ? settings->SpawnBudgetMs * 0.001 : TNumericLimits<double>::Max();
+	const double startTime = FPlatformTime::Seconds();
+
+	int32 spawned = 0;
+	while (SpawnQueue.Num() > 0 && spawned < maxSpawns)
+	{
+		// starting a tree may queue more, re-sort before every pop
+		if (bSpawnQueueDirty)
+		{
+			bSpawnQueueDirty = false;
+			SpawnQueue.Sort([](const FParallelBehaviorSpawnRequest& A, const FParallelBehaviorSpawnRequest& B)
+			{
+				if (A.Setup.SpawnPriority != B.Setup.SpawnPriority)
+				{
+					return A.Setup.SpawnPriority < B.Setup.SpawnPriority;
+				}
+				return A.Sequence > B.Sequence;
+			});
+		}
+
+		FParallelBehaviorSpawnRequest request = SpawnQueue.Pop(EAllowShrinking::No);
+		UParallelBehaviorManagerComponent* manager = request.Manager.Get();
+		if (manager == nullptr)
+		{
+			continue;
+		}
+
+		manager->StartQueuedTree(request.Setup);
+		++spawned;
+
+		// always make progress, at least one tree per frame
+		if (FPlatformTime::Seconds() - startTime >= budgetSeconds)
+		{
+			break;
+		}
+	}
+}
+
+void UParallelBehaviorSubsystem::TickManagedLayers(double InNow, int32 InMaxTicks, bool bInTimeBudget)
+{
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_ManagedTick);
+
+	const double now = InNow;
+
+	// collect due layers, dropping the ones whose component went away without unregistering
+	DueLayers.Reset();
+	for (int32 i = Layers.Num() - 1; i >= 0; --i)
+	{
+		if (!Layers.TreeComponents[i].IsValid())
+		{
+			Layers.RemoveAt(i);
+		}
+	}
+
+	const int32 n = Layers.Num();
+	for (int32 i = 0; i < n; ++i)
+	{
+		const EParallelBehaviorLayerFlags flags = Layers.Flags[i]
+			& (EParallelBehaviorLayerFlags::ManagedTick | EParallelBehaviorLayerFlags::Paused | EParallelBehaviorLayerFlags::Sleeping);
+		if (flags == EParallelBehaviorLayerFlags::ManagedTick && Layers.NextTickTimes[i] <= now)
+		{
+			DueLayers.Add(i);
+		}
+	}
+
+	FilterDueLayersByCondition(now);
+
+	if (DueLayers.Num() == 0)
+	{
+		LastDeferredTicks = 0;
+		SET_DWORD_STAT(STAT_ParallelBehavior_ManagedTicks, 0);
+		return;
+	}
+
+	// overdue layers gain a priority level every PriorityAgingSeconds, so a persistent budget cannot starve
+	// low priorities. Aging follows the scheduler clock, step mode stays reproducible
+	const double agingSeconds = GetDefault<UParallelBehaviorSettings>()->PriorityAgingSeconds;
+	DueSortPriorities.SetNumUninitialized(n, EAllowShrinking::No);
+	for (const int32 index : DueLayers)
+	{
+		const double overdue = FMath::Max(now - Layers.NextTickTimes[index], 0.0);
+		DueSortPriorities[index] = Layers.Priorities[index] + (agingSeconds > 0.0 ? FMath::FloorToDouble(overdue / agingSeconds) : 0.0);
+	}
+
+	// highest aged priority first, then whoever waited the longest (carried over layers come first),
+	// the registry index makes the order total so identical workloads tick in identical order
+	DueLayers.Sort([this](const int32 A, const int32 B)
+	{
+		if (DueSortPriorities[A] != DueSortPriorities[B])
+		{
+			return DueSortPriorities[A] > DueSortPriorities[B];
+		}
+		if (Layers.LastTickTimes[A] != Layers.LastTickTimes[B])
+		{
+			return Layers.LastTickTimes[A] < Layers.LastTickTimes[B];
+		}
+		return A < B;
+	});
+
+	// a tick count budget slices deterministically, a time budget depends on the machine
+	const float budgetMs = GetDefault<UParallelBehaviorSettings>()->ManagedTickBudgetMs;
+	const double budgetSeconds = bInTimeBudget && InMaxTicks <= 0 && budgetMs > 0.0f ? budgetMs * 0.001 : TNumericLimits<double>::Max();
+	const int32 maxTicks = InMaxTicks > 0 ? InMaxTicks : TNumericLimits<int32>::Max();
+	const double startTime = FPlatformTime::Seconds();
+
+	DueHandles.Reset();
+	for (const int32 index : DueLayers)
+	{
+		DueHandles.Add(Layers.GetHandle(index));
+	}
+
+	int32 processed = 0;
+	int32 visited = 0;
+	while (visited < DueHandles.Num())
+	{
+		const FParallelBehaviorLayerHandle handle = DueHandles[visited++];
+
+		// layers removed by an earlier tick this frame are skipped
+		int32 index = Layers.IndexOf(handle);
+		if (index == INDEX_NONE)
+		{
+			continue;
+		}
+
+		UBehaviorTreeComponent* tree = Layers.TreeComponents[index].Get();
+		if (tree != nullptr && tree->IsRegistered())
+		{
+#if STATS
+			FScopeCycleCounter layerScope(Layers.StatIds[index]);
+#endif
+			const uint64 startCycles = FPlatformTime::Cycles64();
+			tree->TickComponent(static_cast<float>(now - Layers.LastTickTimes[index]), LEVELTICK_All, nullptr);
+			const uint64 cycles = FPlatformTime::Cycles64() - startCycles;
+
+			// the tick may have removed this or other layers, moving indices around
+			index = Layers.IndexOf(handle);
+			if (index != INDEX_NONE)
+			{
+				Layers.LastTickCycles[index] = cycles;
+				Layers.TotalTickCycles[index] += cycles;
+				++Layers.TickCounts[index];
+#if PARALLEL_BEHAVIOR_DEBUG
+				Layers.TickHistories[index].Push(cycles);
+				PARALLEL_BEHAVIOR_TRACE_LAYER_TICK(Layers.Agents[index].Get(), Layers.LayerIds[index], *tree, startCycles, cycles);
+#endif
+			}
+		}
+		if (index != INDEX_NONE)
+		{
+			Layers.LastTickTimes[index] = now;
+			Layers.NextTickTimes[index] = now + Layers.TickIntervals[index];
+		}
+		++processed;
+
+		// always make progress, at least one layer per frame
+		if (processed >= maxTicks || FPlatformTime::Seconds() - startTime >= budgetSeconds)
+		{
+			break;
+		}
+	}
+
+	LastDeferredTicks = DueHandles.Num() - visited;
+	SET_DWORD_STAT(STAT_ParallelBehavior_ManagedTicks, processed);
+}
+
+void UParallelBehaviorSubsystem::FilterDueLayersByCondition(double InNow)
+{
+	LastSkippedTicks = 0;
+
+	// thread-safe jobs first so the parallel batch is one contiguous range
+	ConditionJobs.Reset();
+	for (int32 pass = 0; pass < 2; ++pass)
+	{
+		const bool bThreadSafePass = pass == 0;
+		for (int32 i = 0; i < DueLayers.Num(); ++i)
+		{
+			const int32 index = DueLayers[i];
+			if (EnumHasAnyFlags(Layers.Flags[index], EParallelBehaviorLayerFlags::ThreadSafe) != bThreadSafePass)
+			{
+				continue;
+			}
+
+			const UParallelBehaviorTickCondition* condition = Layers.TickConditions[index].Get();
+			const UBlackboardComponent* blackboard = condition != nullptr ? Layers.Blackboards[index].Get() : nullptr;
+			if (blackboard != nullptr)
+			{
+				FParallelBehaviorConditionJob& job = ConditionJobs.AddDefaulted_GetRef();
+				job.DueIndex = i;
+				job.Condition = condition;
+				job.Blackboard = blackboard;
+			}
+		}
+	}
+
+	if (ConditionJobs.Num() == 0)
+	{
+		return;
+	}
+
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_TickConditions);
+
+	int32 numThreadSafe = 0;
+	while (numThreadSafe < ConditionJobs.Num()
+		&& EnumHasAnyFlags(Layers.Flags[DueLayers[ConditionJobs[numThreadSafe].DueIndex]], EParallelBehaviorLayerFlags::ThreadSafe))
+	{
+		++numThreadSafe;
+	}
+
+	// nothing writes to blackboards while the batch runs, the game thread waits for it
+	const UParallelBehaviorSettings* settings = GetDefault<UParallelBehaviorSettings>();
+	const TArrayView<FParallelBehaviorConditionJob> threadSafeJobs(ConditionJobs.GetData(), numThreadSafe);
+	ParallelFor(TEXT("ParallelBehavior.TickConditions"), numThreadSafe, FMath::Max(settings->TickConditionBatchSize, 1),
+		[this, threadSafeJobs](int32 InJobIndex)
+		{
+			FParallelBehaviorConditionJob& job = threadSafeJobs[InJobIndex];
+			job.bPassed = job.Condition->IsSatisfied(*job.Blackboard, Layers.TickConditionKeys[DueLayers[job.DueIndex]]);
+		},
+		settings->bParallelTickConditions ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	for (int32 i = numThreadSafe; i < ConditionJobs.Num(); ++i)
+	{
+		FParallelBehaviorConditionJob& job = ConditionJobs[i];
+		job.bPassed = job.Condition->IsSatisfied(*job.Blackboard, Layers.TickConditionKeys[DueLayers[job.DueIndex]]);
+	}
+
+	// merge on the game thread, failed layers check again after their interval and keep their delta time
+	for (const FParallelBehaviorConditionJob& job : ConditionJobs)
+	{
+		if (!job.bPassed)
+		{
+			const int32 index = DueLayers[job.DueIndex];
+			Layers.NextTickTimes[index] = InNow + Layers.TickIntervals[index];
+			DueLayers[job.DueIndex] = INDEX_NONE;
+			++LastSkippedTicks;
+		}
+	}
+
+	if (LastSkippedTicks > 0)
+	{
+		DueLayers.RemoveAll([](const int32 InIndex) { return InIndex == INDEX_NONE; });
+	}
+}
+
+void UParallelBehaviorSubsystem::UpdateLODs()
+{
+	PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(STAT_ParallelBehavior_UpdateLODs);
+
+	if (Managers.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<8>> viewLocations;
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		if (const APlayerController* pc = it->Get())
+		{
+			FVector location;
+			FRotator rotation;
+			pc->GetPlayerViewPoint(location, rotation);
+			viewLocations.Add(location);
+		}
+	}
+
+	if (viewLocations.Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 i = Managers.Num() - 1; i >= 0; --i)
+	{
+		UParallelBehaviorManagerComponent* manager = Managers[i].Get();
+		if (manager == nullptr)
+		{
+			Managers.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		const APawn* pawn = manager->IsLODEnabled() ? manager->GetPawn() : nullptr;
+		if (pawn == nullptr)
+		{
+			continue;
+		}
+
+		const FVector pawnLocation = pawn->GetActorLocation();
+		double closestDistSq = TNumericLimits<double>::Max();
+		for (const FVector& viewLocation : viewLocations)
+		{
+			closestDistSq = FMath::Min(closestDistSq, FVector::DistSquared(pawnLocation, viewLocation));
+		}
+
+		manager->SetLOD(manager->GetLODForDistance(static_cast<float>(FMath::Sqrt(closestDistSq))));
+	}
+}
+
+TStatId UParallelBehaviorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UParallelBehaviorSubsystem, STATGROUP_ParallelBehavior);
+}
+
+bool UParallelBehaviorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,96 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Tasks/BTTask_ParallelBehaviorPostMessage.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "ParallelBehaviorMessage.h"
+
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+
+UBTTask_ParallelBehaviorPostMessage::UBTTask_ParallelBehaviorPostMessage()
+{
+	NodeName = TEXT("Parallel Post Message");
+
+	FloatKey.AddFloatFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, FloatKey));
+	IntKey.AddIntFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, IntKey));
+	VectorKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, VectorKey));
+	ObjectKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, ObjectKey), UObject::StaticClass());
+	FloatKey.bNoneIsAllowedValue = true;
+	IntKey.bNoneIsAllowedValue = true;
+	VectorKey.bNoneIsAllowedValue = true;
+	ObjectKey.bNoneIsAllowedValue = true;
+}
+
+void UBTTask_ParallelBehaviorPostMessage::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (const UBlackboardData* blackboardAsset = GetBlackboardAsset())
+	{
+		FloatKey.ResolveSelectedKey(*blackboardAsset);
+		IntKey.ResolveSelectedKey(*blackboardAsset);
+		VectorKey.ResolveSelectedKey(*blackboardAsset);
+		ObjectKey.ResolveSelectedKey(*blackboardAsset);
+	}
+}
+
+EBTNodeResult::Type UBTTask_ParallelBehaviorPostMessage::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FParallelBehaviorLayerNodeMemory* memory = CastInstanceNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory);
+	UParallelBehaviorManagerComponent* manager = memory->Resolve(OwnerComp);
+	if (manager == nullptr)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	FParallelBehaviorMessage message;
+	message.Type = MessageType;
+	message.Sender = memory->LayerId;
+
+	if (const UBlackboardComponent* blackboard = OwnerComp.GetBlackboardComponent())
+	{
+		if (FloatKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			message.FloatValue = blackboard->GetValue<UBlackboardKeyType_Float>(FloatKey.GetSelectedKeyID());
+		}
+		if (IntKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			message.IntValue = blackboard->GetValue<UBlackboardKeyType_Int>(IntKey.GetSelectedKeyID());
+		}
+		if (VectorKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			message.VectorValue = blackboard->GetValue<UBlackboardKeyType_Vector>(VectorKey.GetSelectedKeyID());
+		}
+		if (ObjectKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			message.ObjectValue = blackboard->GetValue<UBlackboardKeyType_Object>(ObjectKey.GetSelectedKeyID());
+		}
+	}
+
+	return manager->PostMessage(message, TargetLayer) > 0 ? EBTNodeResult::Succeeded : EBTNodeResult::Failed;
+}
+
+uint16 UBTTask_ParallelBehaviorPostMessage::GetInstanceMemorySize() const
+{
+	return sizeof(FParallelBehaviorLayerNodeMemory);
+}
+
+void UBTTask_ParallelBehaviorPostMessage::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_ParallelBehaviorPostMessage::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory, CleanupType);
+}
+
+FString UBTTask_ParallelBehaviorPostMessage::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("Post %s to %s"), *MessageType.ToString(),
+		TargetLayer.IsNone() ? TEXT("subscribers") : *TargetLayer.ToString());
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Tasks/BTTask_ParallelBehaviorReceiveMessage.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "ParallelBehaviorMessage.h"
+
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+
+UBTTask_ParallelBehaviorReceiveMessage::UBTTask_ParallelBehaviorReceiveMessage()
+{
+	NodeName = TEXT("Parallel Receive Message");
+
+	SenderKey.AddNameFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, SenderKey));
+	FloatKey.AddFloatFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, FloatKey));
+	IntKey.AddIntFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, IntKey));
+	VectorKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, VectorKey));
+	ObjectKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, ObjectKey), UObject::StaticClass());
+	SenderKey.bNoneIsAllowedValue = true;
+	FloatKey.bNoneIsAllowedValue = true;
+	IntKey.bNoneIsAllowedValue = true;
+	VectorKey.bNoneIsAllowedValue = true;
+	ObjectKey.bNoneIsAllowedValue = true;
+}
+
+void UBTTask_ParallelBehaviorReceiveMessage::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (const UBlackboardData* blackboardAsset = GetBlackboardAsset())
+	{
+		SenderKey.ResolveSelectedKey(*blackboardAsset);
+		FloatKey.ResolveSelectedKey(*blackboardAsset);
+		IntKey.ResolveSelectedKey(*blackboardAsset);
+		VectorKey.ResolveSelectedKey(*blackboardAsset);
+		ObjectKey.ResolveSelectedKey(*blackboardAsset);
+	}
+}
+
+EBTNodeResult::Type UBTTask_ParallelBehaviorReceiveMessage::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FParallelBehaviorLayerNodeMemory* memory = CastInstanceNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory);
+	UParallelBehaviorManagerComponent* manager = memory->Resolve(OwnerComp);
+
+	FParallelBehaviorMessage message;
+	if (manager == nullptr || !manager->ReceiveMessageForSlot(manager->GetMessageSlot(memory->LayerId), MessageType, message))
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	if (UBlackboardComponent* blackboard = OwnerComp.GetBlackboardComponent())
+	{
+		if (SenderKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			blackboard->SetValue<UBlackboardKeyType_Name>(SenderKey.GetSelectedKeyID(), message.Sender);
+		}
+		if (FloatKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			blackboard->SetValue<UBlackboardKeyType_Float>(FloatKey.GetSelectedKeyID(), message.FloatValue);
+		}
+		if (IntKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			blackboard->SetValue<UBlackboardKeyType_Int>(IntKey.GetSelectedKeyID(), message.IntValue);
+		}
+		if (VectorKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			blackboard->SetValue<UBlackboardKeyType_Vector>(VectorKey.GetSelectedKeyID(), message.VectorValue);
+		}
+		if (ObjectKey.GetSelectedKeyID() != FBlackboard::InvalidKey)
+		{
+			blackboard->SetValue<UBlackboardKeyType_Object>(ObjectKey.GetSelectedKeyID(), message.ObjectValue);
+		}
+	}
+	return EBTNodeResult::Succeeded;
+}
+
+uint16 UBTTask_ParallelBehaviorReceiveMessage::GetInstanceMemorySize() const
+{
+	return sizeof(FParallelBehaviorLayerNodeMemory);
+}
+
+void UBTTask_ParallelBehaviorReceiveMessage::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_ParallelBehaviorReceiveMessage::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FParallelBehaviorLayerNodeMemory>(NodeMemory, CleanupType);
+}
+
+FString UBTTask_ParallelBehaviorReceiveMessage::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("Receive %s"), MessageType.IsValid() ? *MessageType.ToString() : TEXT("any message"));
+}
\ No newline at end of file
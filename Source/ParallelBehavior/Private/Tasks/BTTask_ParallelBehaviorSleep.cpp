@@ -0,0 +1,70 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Tasks/BTTask_ParallelBehaviorSleep.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+
+#include "BehaviorTree/BehaviorTreeComponent.h"
+
+
+UBTTask_ParallelBehaviorSleep::UBTTask_ParallelBehaviorSleep()
+{
+	NodeName = TEXT("Parallel Sleep");
+	bNotifyTick = true;
+}
+
+EBTNodeResult::Type UBTTask_ParallelBehaviorSleep::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FBTParallelBehaviorSleepMemory* memory = CastInstanceNodeMemory<FBTParallelBehaviorSleepMemory>(NodeMemory);
+
+	// layer components are created with their manager as outer, an actor may carry several managers
+	UParallelBehaviorManagerComponent* manager = Cast<UParallelBehaviorManagerComponent>(OwnerComp.GetOuter());
+	const FName layerId = manager != nullptr ? manager->FindTreeId(&OwnerComp) : NAME_None;
+	if (layerId.IsNone() || !manager->SleepTree(layerId))
+	{
+		return EBTNodeResult::Succeeded;
+	}
+
+	memory->Manager = manager;
+	memory->LayerId = layerId;
+	return EBTNodeResult::InProgress;
+}
+
+void UBTTask_ParallelBehaviorSleep::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	// the layer is only ticked again once it was woken
+	const FBTParallelBehaviorSleepMemory* memory = CastInstanceNodeMemory<FBTParallelBehaviorSleepMemory>(NodeMemory);
+	const UParallelBehaviorManagerComponent* manager = memory->Manager.Get();
+	if (manager == nullptr || !manager->IsTreeSleeping(memory->LayerId))
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+	}
+}
+
+EBTNodeResult::Type UBTTask_ParallelBehaviorSleep::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	const FBTParallelBehaviorSleepMemory* memory = CastInstanceNodeMemory<FBTParallelBehaviorSleepMemory>(NodeMemory);
+	if (UParallelBehaviorManagerComponent* manager = memory->Manager.Get())
+	{
+		manager->WakeTree(memory->LayerId);
+	}
+	return EBTNodeResult::Aborted;
+}
+
+uint16 UBTTask_ParallelBehaviorSleep::GetInstanceMemorySize() const
+{
+	return sizeof(FBTParallelBehaviorSleepMemory);
+}
+
+void UBTTask_ParallelBehaviorSleep::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTParallelBehaviorSleepMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_ParallelBehaviorSleep::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTParallelBehaviorSleepMemory>(NodeMemory, CleanupType);
+}
+
+FString UBTTask_ParallelBehaviorSleep::GetStaticDescription() const
+{
+	return TEXT("Sleeps until a wake key, wake tag or WakeTree wakes the layer");
+}
\ No newline at end of file
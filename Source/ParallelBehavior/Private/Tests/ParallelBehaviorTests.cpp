@@ -0,0 +1,338 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ParallelBehaviorBenchmark.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "Subsystems/ParallelBehaviorSubsystem.h"
+
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Composites/BTComposite_Selector.h"
+#include "BehaviorTree/Tasks/BTTask_Wait.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "UObject/Package.h"
+
+namespace ParallelBehaviorTests
+{
+	constexpr EAutomationTestFlags TestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter;
+
+	const FName ValueKey(TEXT("Value"));
+
+	/** Game world that has begun play, destroyed with the scope */
+	struct FTestWorld
+	{
+		UWorld* World = nullptr;
+
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ParallelBehaviorTestWorld"));
+			FWorldContext& context = GEngine->CreateNewWorldContext(EWorldType::Game);
+			context.SetCurrentWorld(World);
+
+			World->InitializeActorsForPlay(FURL());
+			if (World->GetAISystem() == nullptr)
+			{
+				World->CreateAISystem();
+			}
+			World->GetWorldSettings()->NotifyBeginPlay();
+		}
+
+		~FTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		/** Manager on a fresh AI controller, registered after the pool size was set */
+		UParallelBehaviorManagerComponent* SpawnManager(int32 InMaxPooledPairsPerAsset = 0) const
+		{
+			FActorSpawnParameters spawnParams;
+			spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			AAIController* controller = World->SpawnActor<AAIController>(AAIController::StaticClass(), FTransform::Identity, spawnParams);
+			if (controller == nullptr)
+			{
+				return nullptr;
+			}
+
+			UParallelBehaviorManagerComponent* manager = NewObject<UParallelBehaviorManagerComponent>(controller);
+			if (const FIntProperty* poolProperty = FindFProperty<FIntProperty>(UParallelBehaviorManagerComponent::StaticClass(),
+				TEXT("MaxPooledPairsPerAsset")))
+			{
+				poolProperty->SetPropertyValue_InContainer(manager, InMaxPooledPairsPerAsset);
+			}
+			manager->RegisterComponent();
+			return manager;
+		}
+	};
+
+	/** Transient tree waiting forever under a selector, with a blackboard holding one float key */
+	UBehaviorTree* MakeTree()
+	{
+		UBlackboardData* blackboard = NewObject<UBlackboardData>(GetTransientPackage());
+		FBlackboardEntry& entry = blackboard->Keys.AddDefaulted_GetRef();
+		entry.EntryName = ValueKey;
+		entry.KeyType = NewObject<UBlackboardKeyType_Float>(blackboard);
+		blackboard->UpdateKeyIDs();
+
+		UBehaviorTree* tree = NewObject<UBehaviorTree>(GetTransientPackage());
+		tree->BlackboardAsset = blackboard;
+
+		UBTComposite_Selector* root = NewObject<UBTComposite_Selector>(tree);
+		root->Children.AddDefaulted_GetRef().ChildTask = NewObject<UBTTask_Wait>(tree);
+		tree->RootNode = root;
+		return tree;
+	}
+
+	FParallelBehaviorSetup MakeSetup(UBehaviorTree* InTree, const FName& InId)
+	{
+		FParallelBehaviorSetup setup;
+		setup.Id = InId;
+		setup.BTAsset = InTree;
+		return setup;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelBehaviorRegistryHandleTest, "ParallelBehavior.Registry.Handles",
+	ParallelBehaviorTests::TestFlags)
+
+bool FParallelBehaviorRegistryHandleTest::RunTest(const FString& Parameters)
+{
+	FParallelBehaviorLayerRegistry registry;
+	const FParallelBehaviorLayerHandle first = registry.Add(nullptr, TEXT("First"), nullptr, nullptr);
+	const FParallelBehaviorLayerHandle second = registry.Add(nullptr, TEXT("Second"), nullptr, nullptr);
+	TestEqual(TEXT("First layer index"), registry.IndexOf(first), 0);
+	TestEqual(TEXT("Second layer index"), registry.IndexOf(second), 1);
+
+	// the last layer is swapped into the freed index, its handle follows it
+	TestTrue(TEXT("Remove first"), registry.Remove(first));
+	TestEqual(TEXT("Stale handle"), registry.IndexOf(first), static_cast<int32>(INDEX_NONE));
+	TestEqual(TEXT("Swapped layer index"), registry.IndexOf(second), 0);
+	TestEqual(TEXT("Swapped layer Id"), registry.LayerIds[registry.IndexOf(second)], FName(TEXT("Second")));
+	TestFalse(TEXT("Remove stale handle"), registry.Remove(first));
+
+	// the freed slot is reused with a new serial, the old handle stays stale
+	const FParallelBehaviorLayerHandle third = registry.Add(nullptr, TEXT("Third"), nullptr, nullptr);
+	TestEqual(TEXT("Slot reused"), third.Slot, first.Slot);
+	TestNotEqual(TEXT("Serial bumped"), third.Serial, first.Serial);
+	TestEqual(TEXT("Stale handle after reuse"), registry.IndexOf(first), static_cast<int32>(INDEX_NONE));
+	TestTrue(TEXT("Handle round trip"), registry.GetHandle(registry.IndexOf(third)) == third);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelBehaviorAddRemoveTest, "ParallelBehavior.Manager.AddRemove",
+	ParallelBehaviorTests::TestFlags)
+
+bool FParallelBehaviorAddRemoveTest::RunTest(const FString& Parameters)
+{
+	const ParallelBehaviorTests::FTestWorld testWorld;
+	UParallelBehaviorManagerComponent* manager = testWorld.SpawnManager();
+	if (!TestNotNull(TEXT("Manager"), manager))
+	{
+		return false;
+	}
+
+	UBehaviorTree* tree = ParallelBehaviorTests::MakeTree();
+	const FName layerId(TEXT("Layer"));
+	TestTrue(TEXT("AddTree"), manager->AddTree(ParallelBehaviorTests::MakeSetup(tree, layerId)));
+	TestEqual(TEXT("State after AddTree"), manager->GetLayerState(layerId), EParallelBehaviorLayerState::Running);
+	TestNotNull(TEXT("Tree component"), manager->FindTree(layerId));
+
+	const FParallelBehaviorLayerHandle handle = manager->GetRunningTrees()[0].LayerHandle;
+	const UParallelBehaviorSubsystem* subsystem = testWorld.World->GetSubsystem<UParallelBehaviorSubsystem>();
+	if (TestNotNull(TEXT("Subsystem"), subsystem))
+	{
+		TestNotEqual(TEXT("Layer registered"), subsystem->GetLayers().IndexOf(handle), static_cast<int32>(INDEX_NONE));
+	}
+
+	AddExpectedMessage(TEXT("is already running"), ELogVerbosity::Warning);
+	TestFalse(TEXT("AddTree with a running Id"), manager->AddTree(ParallelBehaviorTests::MakeSetup(tree, layerId)));
+
+	TestTrue(TEXT("RemoveTree"), manager->RemoveTree(layerId));
+	TestEqual(TEXT("State after RemoveTree"), manager->GetLayerState(layerId), EParallelBehaviorLayerState::Inactive);
+	TestNull(TEXT("Tree component after RemoveTree"), manager->FindTree(layerId));
+	TestFalse(TEXT("RemoveTree of a removed Id"), manager->RemoveTree(layerId));
+	if (subsystem != nullptr)
+	{
+		TestEqual(TEXT("Handle stale after RemoveTree"), subsystem->GetLayers().IndexOf(handle), static_cast<int32>(INDEX_NONE));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelBehaviorPoolTest, "ParallelBehavior.Manager.PoolReuse",
+	ParallelBehaviorTests::TestFlags)
+
+bool FParallelBehaviorPoolTest::RunTest(const FString& Parameters)
+{
+	const ParallelBehaviorTests::FTestWorld testWorld;
+	UParallelBehaviorManagerComponent* manager = testWorld.SpawnManager(1);
+	if (!TestNotNull(TEXT("Manager"), manager))
+	{
+		return false;
+	}
+
+	UBehaviorTree* tree = ParallelBehaviorTests::MakeTree();
+	TestTrue(TEXT("AddTree A"), manager->AddTree(ParallelBehaviorTests::MakeSetup(tree, TEXT("A"))));
+	UBehaviorTreeComponent* treeComponent = manager->FindTree(TEXT("A"));
+	if (!TestNotNull(TEXT("Tree component A"), treeComponent) || !TestNotNull(TEXT("Blackboard A"), treeComponent->GetBlackboardComponent()))
+	{
+		return false;
+	}
+	treeComponent->GetBlackboardComponent()->SetValueAsFloat(ParallelBehaviorTests::ValueKey, 2.0f);
+
+	TestTrue(TEXT("RemoveTree A"), manager->RemoveTree(TEXT("A")));
+	TestEqual(TEXT("Pooled pairs after RemoveTree"), manager->GetPooledPairCount(), 1);
+
+	// a layer with another Id reuses the pair of the same asset
+	TestTrue(TEXT("AddTree B"), manager->AddTree(ParallelBehaviorTests::MakeSetup(tree, TEXT("B"))));
+	TestEqual(TEXT("Pooled pairs after AddTree"), manager->GetPooledPairCount(), 0);
+	TestTrue(TEXT("Pooled component reused"), manager->FindTree(TEXT("B")) == treeComponent);
+	TestEqual(TEXT("State of the reused pair"), manager->GetLayerState(TEXT("B")), EParallelBehaviorLayerState::Running);
+
+	UBlackboardComponent* blackboard = manager->FindTree(TEXT("B"))->GetBlackboardComponent();
+	if (TestNotNull(TEXT("Blackboard of the reused pair"), blackboard))
+	{
+		TestEqual(TEXT("Reused blackboard is reset"), blackboard->GetValueAsFloat(ParallelBehaviorTests::ValueKey), 0.0f);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelBehaviorPauseSleepTest, "ParallelBehavior.Manager.PauseSleep",
+	ParallelBehaviorTests::TestFlags)
+
+bool FParallelBehaviorPauseSleepTest::RunTest(const FString& Parameters)
+{
+	const ParallelBehaviorTests::FTestWorld testWorld;
+	UParallelBehaviorManagerComponent* manager = testWorld.SpawnManager();
+	if (!TestNotNull(TEXT("Manager"), manager))
+	{
+		return false;
+	}
+
+	const FName layerId(TEXT("Layer"));
+	TestTrue(TEXT("AddTree"), manager->AddTree(ParallelBehaviorTests::MakeSetup(ParallelBehaviorTests::MakeTree(), layerId)));
+
+	TestTrue(TEXT("PauseTree"), manager->PauseTree(layerId));
+	TestTrue(TEXT("IsTreePaused"), manager->IsTreePaused(layerId));
+	TestEqual(TEXT("State after PauseTree"), manager->GetLayerState(layerId), EParallelBehaviorLayerState::Paused);
+	TestTrue(TEXT("ResumeTree"), manager->ResumeTree(layerId));
+	TestEqual(TEXT("State after ResumeTree"), manager->GetLayerState(layerId), EParallelBehaviorLayerState::Running);
+
+	TestTrue(TEXT("SleepTree"), manager->SleepTree(layerId));
+	TestTrue(TEXT("IsTreeSleeping"), manager->IsTreeSleeping(layerId));
+	TestEqual(TEXT("State after SleepTree"), manager->GetLayerState(layerId), EParallelBehaviorLayerState::Sleeping);
+	TestTrue(TEXT("WakeTree"), manager->WakeTree(layerId));
+	TestEqual(TEXT("State after WakeTree"), manager->GetLayerState(layerId), EParallelBehaviorLayerState::Running);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelBehaviorMessageTest, "ParallelBehavior.Manager.Messages",
+	ParallelBehaviorTests::TestFlags)
+
+bool FParallelBehaviorMessageTest::RunTest(const FString& Parameters)
+{
+	const ParallelBehaviorTests::FTestWorld testWorld;
+	UParallelBehaviorManagerComponent* manager = testWorld.SpawnManager();
+	if (!TestNotNull(TEXT("Manager"), manager))
+	{
+		return false;
+	}
+
+	UBehaviorTree* tree = ParallelBehaviorTests::MakeTree();
+	TestTrue(TEXT("AddTree A"), manager->AddTree(ParallelBehaviorTests::MakeSetup(tree, TEXT("A"))));
+	TestTrue(TEXT("AddTree B"), manager->AddTree(ParallelBehaviorTests::MakeSetup(tree, TEXT("B"))));
+
+	FParallelBehaviorMessage message;
+	message.Sender = TEXT("B");
+	message.IntValue = 42;
+	TestEqual(TEXT("Recipients of a targeted message"), manager->PostMessage(message, TEXT("A")), 1);
+	TestEqual(TEXT("Recipients of an unknown layer"), manager->PostMessage(message, TEXT("Missing")), 0);
+
+	TestFalse(TEXT("No message for the other layer"), manager->HasMessage(TEXT("B"), FGameplayTag()));
+	FParallelBehaviorMessage received;
+	TestTrue(TEXT("ReceiveMessage"), manager->ReceiveMessage(TEXT("A"), FGameplayTag(), received));
+	TestEqual(TEXT("Received value"), received.IntValue, 42);
+	TestEqual(TEXT("Received sender"), received.Sender, FName(TEXT("B")));
+	TestFalse(TEXT("Message consumed"), manager->ReceiveMessage(TEXT("A"), FGameplayTag(), received));
+
+	// a message wakes a sleeping recipient
+	TestTrue(TEXT("SleepTree"), manager->SleepTree(TEXT("A")));
+	TestEqual(TEXT("Recipients of a sleeping layer"), manager->PostMessage(message, TEXT("A")), 1);
+	TestEqual(TEXT("State after the message"), manager->GetLayerState(TEXT("A")), EParallelBehaviorLayerState::Running);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelBehaviorSnapshotTest, "ParallelBehavior.Manager.Snapshot",
+	ParallelBehaviorTests::TestFlags)
+
+bool FParallelBehaviorSnapshotTest::RunTest(const FString& Parameters)
+{
+	const ParallelBehaviorTests::FTestWorld testWorld;
+	UParallelBehaviorManagerComponent* manager = testWorld.SpawnManager();
+	if (!TestNotNull(TEXT("Manager"), manager))
+	{
+		return false;
+	}
+
+	UBehaviorTree* tree = ParallelBehaviorTests::MakeTree();
+	TestTrue(TEXT("AddTree A"), manager->AddTree(ParallelBehaviorTests::MakeSetup(tree, TEXT("A"))));
+	TestTrue(TEXT("AddTree B"), manager->AddTree(ParallelBehaviorTests::MakeSetup(tree, TEXT("B"))));
+
+	UBlackboardComponent* blackboard = manager->FindTree(TEXT("A"))->GetBlackboardComponent();
+	if (!TestNotNull(TEXT("Blackboard"), blackboard))
+	{
+		return false;
+	}
+	blackboard->SetValueAsFloat(ParallelBehaviorTests::ValueKey, 3.5f);
+	TestTrue(TEXT("PauseTree B"), manager->PauseTree(TEXT("B")));
+
+	const FParallelBehaviorSnapshot snapshot = manager->CaptureSnapshot();
+	TestEqual(TEXT("Captured layers"), snapshot.Layers.Num(), 2);
+
+	TestTrue(TEXT("RemoveTree A"), manager->RemoveTree(TEXT("A")));
+	TestTrue(TEXT("RemoveTree B"), manager->RemoveTree(TEXT("B")));
+	TestEqual(TEXT("Restored layers"), manager->RestoreSnapshot(snapshot), 2);
+	TestEqual(TEXT("State of A"), manager->GetLayerState(TEXT("A")), EParallelBehaviorLayerState::Running);
+	TestEqual(TEXT("State of B"), manager->GetLayerState(TEXT("B")), EParallelBehaviorLayerState::Paused);
+
+	blackboard = manager->FindTree(TEXT("A"))->GetBlackboardComponent();
+	if (TestNotNull(TEXT("Restored blackboard"), blackboard))
+	{
+		TestEqual(TEXT("Restored value"), blackboard->GetValueAsFloat(ParallelBehaviorTests::ValueKey), 3.5f);
+	}
+
+	// running Ids are skipped
+	TestEqual(TEXT("Restore over running layers"), manager->RestoreSnapshot(snapshot), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelBehaviorBenchmarkTest, "ParallelBehavior.Benchmark",
+	ParallelBehaviorTests::TestFlags)
+
+bool FParallelBehaviorBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const ParallelBehaviorTests::FTestWorld testWorld;
+
+	ParallelBehaviorBenchmark::FResult result;
+	result.Agents = 16;
+	result.Layers = 4;
+	result.Frames = 8;
+	result.ChurnCycles = 4;
+	if (!TestTrue(TEXT("RunScenario"), ParallelBehaviorBenchmark::RunScenario(testWorld.World, ParallelBehaviorTests::MakeTree(), result)))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Started layers"), result.StartedLayers, result.Agents * result.Layers);
+	TestEqual(TEXT("Layers running after churn"), result.RunningLayers, result.Agents * result.Layers);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -5,9 +5,68 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "Engine/TimerHandle.h"
+#include "GameplayTagContainer.h"
+#include "ParallelBehaviorBlackboardValue.h"
+#include "ParallelBehaviorLayerSummary.h"
+#include "ParallelBehaviorMessage.h"
+#include "ParallelBehaviorTypes.h"
+#include "StructUtils/InstancedStruct.h"
 #include "ParallelBehaviorManagerComponent.generated.h"
 
+struct FParallelBehaviorBlackboardLayout;
+struct FStreamableHandle;
+class FDataValidationContext;
+class UParallelBehaviorArchetype;
+class UParallelBehaviorProcessor;
+class UParallelBehaviorSquad;
+class UParallelBehaviorSubsystem;
+class UParallelBehaviorTickCondition;
+
+/** Broadcast when trees requested through an async path have finished loading and were started */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FParallelBehaviorTreesStartedSignature, const TArray<FName>&, StartedIds);
+
+/** Broadcast once the default trees of a manager are all loaded and started */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FParallelBehaviorReadySignature);
+
+/** Broadcast on clients when the replicated state of a layer changed, Inactive once it was removed */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FParallelBehaviorLayerStateSignature, FName, LayerId, EParallelBehaviorLayerState, State);
+
+/**
+ * @enum EParallelBehaviorPauseReason
+ * @brief Why a running tree is paused, a tree only resumes once every reason is cleared
+ */
+enum class EParallelBehaviorPauseReason : uint8
+{
+	None = 0,
+	/** Paused because the agent's LOD is above the layer's MaxLOD */
+	LOD = 1 << 0,
+	/** Paused through UParallelBehaviorSubsystem::SetWorldPaused */
+	World = 1 << 1,
+	/** Paused through PauseTree / PauseAll */
+	User = 1 << 2,
+	/** Paused because the owner's tags fail the layer's ActivationQuery or match its DeactivationQuery */
+	Tags = 1 << 3,
+};
+ENUM_CLASS_FLAGS(EParallelBehaviorPauseReason);
+
+/**
+ * @enum EParallelBehaviorStopMode
+ * @brief How a layer's tree is stopped when it is stopped or removed
+ */
+UENUM(BlueprintType)
+enum class EParallelBehaviorStopMode : uint8
+{
+	/** Use the layer setup's StopMode (Safe when the setup uses Default as well) */
+	Default,
+	/** Aborts active tasks and waits for latent aborts to finish (EBTStopMode::Safe) */
+	Safe,
+	/** Aborts active tasks without waiting for latent aborts, cheaper for mass teardown (EBTStopMode::Forced) */
+	Forced,
+};
+
 /**
  * @struct FParallelBehaviorSetup
  * @brief Configuration for a single parallel behavior tree instance
@@ -21,9 +80,166 @@ struct FParallelBehaviorSetup
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FName Id = NAME_None;
 
-	/** Behavior tree asset to run */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	/**
+	 * Behavior tree asset to run. The "Behavior" asset bundle only applies when the setup lives in a primary asset
+	 * such as UParallelBehaviorArchetype, setups on a manager are plain soft references.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AssetBundles = "Behavior"))
 	TSoftObjectPtr<UBehaviorTree> BTAsset;
+
+	/**
+	 * Run the layer as a lightweight processor over packed fragments instead of a behavior tree, BTAsset is ignored.
+	 * Processor layers have no BT or Blackboard component, meant for background crowd agents.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<UParallelBehaviorProcessor> Processor;
+
+	/** Initial state of a processor layer, must use the processor's fragment type. Empty starts from the fragment defaults */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Processor != nullptr"))
+	FInstancedStruct InitialFragment;
+
+	/**
+	 * Blackboard values written before the tree starts, so its first evaluation already sees them.
+	 * Keys missing from the tree's blackboard are ignored.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FParallelBehaviorBlackboardValue> InitialValues;
+
+	/**
+	 * Seconds between ticks of this tree, 0 ticks every frame.
+	 * Trees with an interval are always driven by the managed tick scheduler (UParallelBehaviorSubsystem).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", Units = "s"))
+	float TickInterval = 0.0f;
+
+	/** Higher priority trees are ticked first when the managed tick budget runs out */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Priority = 0;
+
+	/** Higher priority setups leave the spawn queue first (locomotion, combat...), see QueueTree */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 SpawnPriority = 0;
+
+	/** Delay the first tick by a random fraction of TickInterval so agents spawned together do not tick together */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bRandomTickPhase = true;
+
+	/**
+	 * Highest LOD level this layer keeps running at, it is paused (Blackboard and active node kept) above it.
+	 * -1 runs at every LOD. Only used when the manager has LOD enabled.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "-1"))
+	int32 MaxLOD = -1;
+
+	/**
+	 * Tick interval per LOD level (index = LOD), overriding TickInterval while the agent is at that LOD.
+	 * LODs past the end use the last entry, empty keeps TickInterval at every LOD.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", Units = "s"))
+	TArray<float> LODTickIntervals;
+
+	/**
+	 * Optional gate checked before every managed tick, the tick is skipped while it fails.
+	 * Only used when the tree is driven by the managed tick scheduler.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Instanced)
+	TObjectPtr<UParallelBehaviorTickCondition> TickCondition = nullptr;
+
+	/**
+	 * TickCondition only reads the blackboard and may be evaluated on worker threads,
+	 * batched with the conditions of every other thread-safe layer in the world.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bThreadSafe = false;
+
+	/**
+	 * Blackboard keys waking the layer from sleep when their value changes (see SleepTree and the Parallel Sleep task).
+	 * Mirrored shared keys count as well.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FName> WakeKeys;
+
+	/** Gameplay events waking the layer from sleep, see NotifyGameplayEvent */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTagContainer WakeTags;
+
+	/** Message types (and their child tags) delivered to this layer when posted without a target layer */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTagContainer MessageTags;
+
+	/** How the tree is stopped by StopTree / RemoveTree calls that do not pass a stop mode */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EParallelBehaviorStopMode StopMode = EParallelBehaviorStopMode::Safe;
+
+	/**
+	 * Owner tags the layer needs to run, evaluated whenever the manager is told the tags changed
+	 * (see NotifyOwnerTagsChanged). Empty runs regardless of the tags.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTagQuery ActivationQuery;
+
+	/** Owner tags deactivating the layer even while ActivationQuery matches. Empty never deactivates */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTagQuery DeactivationQuery;
+
+	/**
+	 * Release an inactive tree's components to the pool instead of pausing it, it restarts from this setup once
+	 * activated again (Blackboard and active node are lost). Processor layers are always released.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bReleaseWhenInactive = false;
+};
+
+/**
+ * @struct FParallelBehaviorLayerSnapshot
+ * @brief State of one layer captured by UParallelBehaviorManagerComponent::CaptureSnapshot
+ */
+USTRUCT()
+struct FParallelBehaviorLayerSnapshot
+{
+	GENERATED_BODY()
+
+	/** Setup the layer was started with, Id resolved. Processor layers carry their fragment as InitialFragment */
+	UPROPERTY()
+	FParallelBehaviorSetup Setup;
+
+	/** Blackboard asset the values were captured from, values are only restored into the same asset */
+	UPROPERTY()
+	TObjectPtr<UBlackboardData> BlackboardAsset = nullptr;
+
+	/** Raw value memory of the layout's SnapshotKeys, back to back. Only valid within the running process */
+	UPROPERTY()
+	TArray<uint8> Values;
+
+	/** Values of the layout's StringKeys */
+	UPROPERTY()
+	TArray<FString> StringValues;
+
+	/** Paused through PauseTree / PauseAll */
+	UPROPERTY()
+	bool bPaused = false;
+
+	UPROPERTY()
+	bool bSleeping = false;
+};
+
+/**
+ * @struct FParallelBehaviorSnapshot
+ * @brief Blackboards and layer states of a manager, restored into fresh or pooled components by RestoreSnapshot
+ *
+ * Trees restart from their root with the captured blackboard, the active node is not restored.
+ * Object values are weak references, a snapshot is meant for streaming within one session, not for save games.
+ */
+USTRUCT(BlueprintType)
+struct FParallelBehaviorSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FParallelBehaviorLayerSnapshot> Layers;
+
+public:
+	bool IsEmpty() const { return Layers.Num() == 0; }
 };
 
 /**
@@ -61,6 +277,154 @@ public:
 
 	UPROPERTY()
 	TWeakObjectPtr<UBlackboardComponent> BlackboardComponent;
+
+	/** Asset the tree was started with, used as the pool key when the tree is removed */
+	UPROPERTY()
+	TWeakObjectPtr<UBehaviorTree> BTAsset;
+
+	/** Tree is ticked by UParallelBehaviorSubsystem rather than its own tick function */
+	UPROPERTY()
+	bool bManagedTick = false;
+
+	/** Setup the tree was added with, Priority is updated by SetTreePriority */
+	UPROPERTY()
+	FParallelBehaviorSetup Setup;
+
+	/** Active EParallelBehaviorPauseReason flags */
+	EParallelBehaviorPauseReason PauseReasons = EParallelBehaviorPauseReason::None;
+
+	/** Entry of this layer in the UParallelBehaviorSubsystem registry */
+	FParallelBehaviorLayerHandle LayerHandle;
+
+	/** Tree does not tick until an event wakes it, see SleepTree */
+	bool bSleeping = false;
+
+	/** Bit of this layer in the manager's message recipient masks, INDEX_NONE once every slot is taken */
+	int32 MessageSlot = INDEX_NONE;
+};
+
+/**
+ * @struct FParallelBehaviorLayerStats
+ * @brief Snapshot of the state and cost of one running layer, see UParallelBehaviorManagerComponent::GetLayerStats
+ *
+ * Tick timings are only measured for layers driven by the managed tick scheduler.
+ */
+USTRUCT(BlueprintType)
+struct FParallelBehaviorLayerStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FName Id = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bManagedTick = false;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bPaused = false;
+
+	UPROPERTY(BlueprintReadOnly)
+	float TickInterval = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Priority = 0;
+
+	/** Managed ticks since the layer was added */
+	UPROPERTY(BlueprintReadOnly)
+	int32 TickCount = 0;
+
+	/** CPU time of the last managed tick */
+	UPROPERTY(BlueprintReadOnly)
+	float LastTickMs = 0.0f;
+
+	/** Average CPU time of a managed tick */
+	UPROPERTY(BlueprintReadOnly)
+	float AverageTickMs = 0.0f;
+
+	/** CPU time of every managed tick since the layer was added */
+	UPROPERTY(BlueprintReadOnly)
+	float TotalTickMs = 0.0f;
+};
+
+/**
+ * @struct FParallelBehaviorMemoryStats
+ * @brief Estimated memory owned by one manager's layers (or a whole world), see GetMemoryStats
+ *
+ * Component bytes are the class sizes of the components, excluding engine side allocations they own.
+ */
+USTRUCT(BlueprintType)
+struct PARALLELBEHAVIOR_API FParallelBehaviorMemoryStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumLayers = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumBlackboards = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumPooledPairs = 0;
+
+	/** RunningTrees, the Id lookup and the setups copied into each runtime */
+	UPROPERTY(BlueprintReadOnly)
+	int64 RuntimeBytes = 0;
+
+	/** Value memory of every layer blackboard */
+	UPROPERTY(BlueprintReadOnly)
+	int64 BlackboardValueBytes = 0;
+
+	/** Node instance memory of every running tree's root instance */
+	UPROPERTY(BlueprintReadOnly)
+	int64 TreeInstanceBytes = 0;
+
+	/** BT and Blackboard components of the running layers */
+	UPROPERTY(BlueprintReadOnly)
+	int64 ComponentBytes = 0;
+
+	/** Pooled component pairs, including their blackboard value memory */
+	UPROPERTY(BlueprintReadOnly)
+	int64 PoolBytes = 0;
+
+	/** Message ring buffer and subscriptions */
+	UPROPERTY(BlueprintReadOnly)
+	int64 MessageBytes = 0;
+
+	/** Layer registry of the world subsystem, only filled by UParallelBehaviorSubsystem::GetMemoryStats */
+	UPROPERTY(BlueprintReadOnly)
+	int64 RegistryBytes = 0;
+
+public:
+	int64 GetTotalBytes() const
+	{
+		return RuntimeBytes + BlackboardValueBytes + TreeInstanceBytes + ComponentBytes + PoolBytes + MessageBytes + RegistryBytes;
+	}
+
+	FParallelBehaviorMemoryStats& operator+=(const FParallelBehaviorMemoryStats& InOther);
+};
+
+/**
+ * @struct FParallelBehaviorPooledPair
+ * @brief Stopped, unregistered BT/Blackboard component pair kept for reuse
+ */
+USTRUCT()
+struct FParallelBehaviorPooledPair
+{
+	GENERATED_BODY()
+
+	/** Behavior tree asset the pair was created for */
+	UPROPERTY()
+	TObjectPtr<UBehaviorTree> BTAsset = nullptr;
+
+	/** Blackboard asset the pair's blackboard is initialized with */
+	UPROPERTY()
+	TObjectPtr<UBlackboardData> BlackboardAsset = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UBehaviorTreeComponent> TreeComponent = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UBlackboardComponent> BlackboardComponent = nullptr;
 };
 
 /**
@@ -83,19 +447,448 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior", DisplayName="Behaviors")
 	TArray<FParallelBehaviorSetup> ParallelBehaviorDefaults;
 
+	/**
+	 * Shared layer set started before ParallelBehaviorDefaults. Its trees are loaded and resolved once
+	 * for every manager referencing it, prefer it over per-Blueprint defaults for agents spawned in numbers.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior")
+	TObjectPtr<UParallelBehaviorArchetype> Archetype = nullptr;
+
+	/**
+	 * Capture a snapshot into UParallelBehaviorSubsystem when the owner is streamed out, and restore it instead of
+	 * starting the default trees when an owner with the same SnapshotKey begins play again.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior")
+	bool bPersistAcrossStreaming = false;
+
+	/** Key the snapshot is stored under, none uses the path of the controlled pawn (or of the owner) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Behavior", meta = (EditCondition = "bPersistAcrossStreaming"))
+	FName SnapshotKey = NAME_None;
+
+	/** Stream default tree assets in asynchronously on BeginPlay instead of resolving them on the game thread */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior")
+	bool bLoadDefaultTreesAsync = true;
+
+	/**
+	 * Layer capacity reserved on BeginPlay on top of the archetype and default layers, so trees added at runtime
+	 * do not grow the layer storage.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior", meta = (ClampMin = "0"))
+	int32 ReservedLayerSlack = 4;
+
+	/**
+	 * Hard reference the default trees on save, so they are loaded (and cooked) together with the level or
+	 * blueprint owning this component and BeginPlay never has to load them. Trades the BeginPlay load hitch for
+	 * memory and load time of the owner: the trees stay resident as long as the owner is loaded and
+	 * bLoadDefaultTreesAsync no longer has anything to stream.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior")
+	bool bPreloadDefaultTrees = false;
+
+	/** Trees of ParallelBehaviorDefaults collected on save when bPreloadDefaultTrees is set */
+	UPROPERTY()
+	TArray<TObjectPtr<UBehaviorTree>> PreloadedTrees;
+
+	/**
+	 * Start default trees through the world spawn queue instead of all on BeginPlay, so agents spawned
+	 * together are activated over several frames (UParallelBehaviorSettings::MaxSpawnsPerFrame / SpawnBudgetMs).
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior")
+	bool bDeferDefaultTrees = false;
+
+	/**
+	 * Maximum number of stopped component pairs kept per behavior tree asset.
+	 * Removed trees are recycled into the pool instead of being destroyed, 0 disables pooling.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pool", meta = (ClampMin = "0"))
+	int32 MaxPooledPairsPerAsset = 0;
+
+	/**
+	 * Keep per layer overhead to a minimum for agents spawned in large numbers. Trees without a blackboard asset
+	 * are expected to run without one (no warning), and setup data only needed at start is not kept in the runtime.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pool")
+	bool bLeanLayers = false;
+
+	/**
+	 * Let UParallelBehaviorSubsystem tick this manager's trees instead of each tree registering its own tick.
+	 * The subsystem ticks round-robin under UParallelBehaviorSettings::ManagedTickBudgetMs.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Tick")
+	bool bUseManagedTick = false;
+
+	/**
+	 * Let UParallelBehaviorSubsystem assign a LOD level from the distance to the closest player viewpoint.
+	 * Layers pause above their MaxLOD and switch to their LODTickIntervals.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "LOD")
+	bool bEnableLOD = false;
+
+	/**
+	 * Ascending distance thresholds between LOD levels. Closer than LODDistances[0] is LOD 0,
+	 * between LODDistances[0] and LODDistances[1] is LOD 1 and so on.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "LOD", meta = (EditCondition = "bEnableLOD", Units = "cm"))
+	TArray<float> LODDistances = { 3000.0f, 8000.0f, 15000.0f };
+
+	/** LOD level currently applied to the layers */
+	int32 CurrentLOD = 0;
+
+	/**
+	 * Blackboard holding facts common to every layer (SelfActor, target, perception results...).
+	 * Write them once into GetSharedBlackboard(), every layer blackboard key with the same name and type
+	 * mirrors the value. Mirrored keys are read-only for the layers, their own writes are overwritten on the next shared write.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Shared Blackboard")
+	TObjectPtr<UBlackboardData> SharedBlackboardAsset = nullptr;
+
+	/** Only mirror these keys of the shared blackboard, empty mirrors every key */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Shared Blackboard")
+	TArray<FName> SharedKeys;
+
+	/** Runtime instance of SharedBlackboardAsset */
+	UPROPERTY(Transient)
+	TObjectPtr<UBlackboardComponent> SharedBlackboard = nullptr;
+
+	/** Layer key per shared key ID, cached per layer blackboard asset */
+	TMap<TObjectKey<UBlackboardData>, TArray<FBlackboard::FKey>> SharedKeyRoutes;
+
+	/** Squad joined on BeginPlay, created by the subsystem with SquadBlackboardAsset if it does not exist yet */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Squad")
+	FName DefaultSquadId = NAME_None;
+
+	/** Blackboard asset used when DefaultSquadId has to be created */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Squad")
+	TObjectPtr<UBlackboardData> SquadBlackboardAsset = nullptr;
+
+	/** Only mirror these keys of the squad blackboard, empty mirrors every key. Mirrored keys are read-only for the layers */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Squad")
+	TArray<FName> SquadKeys;
+
+	/** Squad this manager is a member of */
+	UPROPERTY(Transient)
+	TObjectPtr<UParallelBehaviorSquad> Squad = nullptr;
+
+	/** Layer key per squad key ID, cached per layer blackboard asset */
+	TMap<TObjectKey<UBlackboardData>, TArray<FBlackboard::FKey>> SquadKeyRoutes;
+
+	/**
+	 * Replicate the Id and coarse state of every layer to clients (animation, UI), a few bytes per change.
+	 * Blackboards are never replicated. Makes the component replicated, its owner must replicate as well.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication")
+	bool bReplicateLayerSummary = false;
+
+	/**
+	 * Seconds between two refreshes of the summary on the server, changes in between are batched.
+	 * The owner's net update frequency still decides when a refreshed summary is sent.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication",
+		meta = (ClampMin = "0.01", Units = "s", EditCondition = "bReplicateLayerSummary"))
+	float LayerSummaryUpdateInterval = 0.25f;
+
+	UPROPERTY(Replicated)
+	FParallelBehaviorLayerSummary LayerSummary;
+
+	FTimerHandle LayerSummaryTimer;
+
+public:
+	/**
+	 * Called when trees requested through AddTreeAsync / AddTreesAsync / RunDefaultTreesAsync were loaded and started.
+	 * Deferred default trees are reported through OnBehaviorReady instead.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Manage")
+	FParallelBehaviorTreesStartedSignature OnTreesStarted;
+
+	/** Called once every default tree is loaded and started, see IsBehaviorReady */
+	UPROPERTY(BlueprintAssignable, Category = "Manage")
+	FParallelBehaviorReadySignature OnBehaviorReady;
+
+	/** Called on clients for every replicated layer state change, see bReplicateLayerSummary */
+	UPROPERTY(BlueprintAssignable, Category = "Replication")
+	FParallelBehaviorLayerStateSignature OnLayerStateReplicated;
+
 protected:
 	/** All currently active parallel trees */
 	UPROPERTY()
 	TArray<FParallelBehaviorRuntime> RunningTrees;
 
+	/** Index of each running tree in RunningTrees, kept in sync by AddTree / RemoveTree */
+	TMap<FName, int32> TreeIndexById;
+
+	/** Running processor layers, they share the Id space of RunningTrees */
+	TMap<FName, FParallelBehaviorProcessorHandle> ProcessorLayers;
+
+	/** Owner tags the setups' activation queries are evaluated against, see NotifyOwnerTagsChanged */
+	UPROPERTY(Transient)
+	FGameplayTagContainer OwnerTags;
+
+	/** Released layers whose activation query fails, started from their setup once it matches */
+	UPROPERTY(Transient)
+	TArray<FParallelBehaviorSetup> InactiveLayers;
+
+	/** Setups of running processor layers with activation queries, needed to start them again after their release */
+	UPROPERTY(Transient)
+	TMap<FName, FParallelBehaviorSetup> GatedProcessorSetups;
+
+	/** Counter used to build IDs for setups added without one */
+	int32 GeneratedIdCounter = 0;
+
+	/** Number part of the names of created components, unique within this manager without a name search */
+	int32 ComponentNameCounter = 0;
+
+	/** Setups waiting in the subsystem spawn queue */
+	int32 NumQueuedTrees = 0;
+
+	/** Waiting for Archetype to finish loading before its layers are started */
+	bool bAwaitingArchetype = false;
+
+	/** OnBehaviorReady was broadcast */
+	bool bBehaviorReady = false;
+
+	/** PauseAll is active, trees added meanwhile start paused */
+	bool bAllPaused = false;
+
+protected:
+	/** Number of layers that can receive messages, one bit of a recipient mask each */
+	static constexpr int32 MaxMessageSlots = 64;
+
+	/** Size of the message ring buffer, the oldest message is dropped once it is full */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Messages", meta = (ClampMin = "1"))
+	int32 MessageCapacity = 32;
+
+	/** Ring buffer of posted messages, allocated once with MessageCapacity entries */
+	UPROPERTY(Transient)
+	TArray<FParallelBehaviorMessage> MessageRing;
+
+	/** Layers that still have to receive each message, one bit per message slot */
+	TArray<uint64> MessageRecipients;
+
+	/** Ring index of the oldest message */
+	int32 MessageHead = 0;
+
+	/** Number of ring entries in use, starting at MessageHead */
+	int32 MessageCount = 0;
+
+	/** Layer Id owning each message slot */
+	FName MessageSlotIds[MaxMessageSlots];
+
+	/** Messages waiting per message slot */
+	uint16 PendingMessages[MaxMessageSlots] = {};
+
+	/** Message slots taken by running layers */
+	uint64 UsedMessageSlots = 0;
+
+	/** Layers subscribed to each message tag */
+	TMap<FGameplayTag, uint64> MessageSubscribers;
+
+	/** Decorators to re-evaluate when their layer receives a message */
+	TArray<FParallelBehaviorMessageWatcher> MessageWatchers;
+
+protected:
+	/** Stopped component pairs ready to be reused by AddTree */
+	UPROPERTY(Transient)
+	TArray<FParallelBehaviorPooledPair> ComponentPool;
+
+	/** In-flight streaming requests issued by the async add path */
+	TArray<TSharedPtr<FStreamableHandle>> PendingLoads;
+
 protected:
 	/** Automatically start default trees */
 	UFUNCTION()
 	void RunDefaultTrees();
 
+	/** Streams in all default tree assets with a single request and starts them once loaded */
+	UFUNCTION()
+	void RunDefaultTreesAsync();
+
+	/**
+	 * Streams in the assets of the given setups with a single request, then starts or queues them.
+	 *
+	 * @param bInQueue Hand the loaded setups to the spawn queue instead of starting them right away.
+	 */
+	bool LoadTrees(const TArray<FParallelBehaviorSetup>& InSetups, bool bInQueue);
+
+	/** Starts (or queues) every setup whose asset is now resident and broadcasts OnTreesStarted for the started ones */
+	void StartLoadedTrees(const TArray<FParallelBehaviorSetup>& InSetups, bool bInQueue);
+
+	/** Broadcasts OnBehaviorReady once nothing is loading or queued anymore */
+	void UpdateBehaviorReady();
+
+	/** Cancels every in-flight streaming request */
+	void CancelPendingLoads();
+
+	/** Creates a new, unregistered BT/Blackboard component pair for the given asset, named from ComponentNameCounter */
+	void CreatePair(UBehaviorTree* InBTAsset,
+		UBehaviorTreeComponent*& OutTreeComponent, UBlackboardComponent*& OutBlackboardComponent);
+
+	/** Takes a pooled pair matching the given asset out of the pool, returns false if none is available */
+	bool AcquirePooledPair(const UBehaviorTree* InBTAsset,
+		UBehaviorTreeComponent*& OutTreeComponent, UBlackboardComponent*& OutBlackboardComponent);
+
+	/**
+	 * Stops the runtime's tree and returns its components to the pool, or destroys them if the pool is full.
+	 *
+	 * @param bInDeferDestroy Hand components that do not fit into the pool to the subsystem, destroyed over the next frames.
+	 */
+	void ReleasePair(FParallelBehaviorRuntime& InRuntime, EParallelBehaviorStopMode InStopMode, bool bInDeferDestroy = false);
+
+	/** Destroys a component pair now, or through the subsystem over the next frames when deferred */
+	void DestroyPair(UBehaviorTreeComponent* InTreeComponent, UBlackboardComponent* InBlackboardComponent, bool bInDefer);
+
+	/** BT stop mode for a layer, InStopMode Default falls back to the setup */
+	static EBTStopMode::Type ResolveStopMode(const FParallelBehaviorSetup& InSetup, EParallelBehaviorStopMode InStopMode);
+
+	/** Clears every key of a blackboard so a recycled pair starts from default values */
+	static void ResetBlackboardValues(UBlackboardComponent& InBlackboard);
+
+	/** Number of pooled pairs for the given asset */
+	int32 CountPooledPairs(const UBehaviorTree* InBTAsset) const;
+
+	/** Index of the tree with the given ID in RunningTrees, INDEX_NONE if not running */
+	int32 FindTreeIndex(const FName& InId) const;
+
+	/** Swap-removes an entry from RunningTrees and patches the index of the moved entry */
+	void RemoveRuntimeAtSwap(int32 InIndex);
+
+	/** AddTree, restoring the blackboard values and state of InSnapshot when given */
+	bool AddTreeInternal(const FParallelBehaviorSetup& InSetup, const FParallelBehaviorLayerSnapshot* InSnapshot);
+
+	/** Copies captured values into a blackboard whose tree has not started yet */
+	static void RestoreBlackboardValues(UBlackboardComponent& InBlackboard, const FParallelBehaviorBlackboardLayout& InLayout,
+		const FParallelBehaviorLayerSnapshot& InSnapshot);
+
+	/** Removes every processor layer of this manager from the subsystem */
+	void RemoveAllProcessorLayers();
+
+	/** Whether a running or inactive layer uses the Id */
+	bool IsLayerIdTaken(const FName& InId) const;
+
+	/** Whether the setup has an activation or deactivation query */
+	static bool HasActivationQueries(const FParallelBehaviorSetup& InSetup);
+
+	/** Whether the setup's queries let the layer run with the current OwnerTags */
+	bool IsSetupActive(const FParallelBehaviorSetup& InSetup) const;
+
+	/** Fills OutTags from the owner or pawn implementing IGameplayTagAssetInterface, false without a tag source */
+	bool ReadOwnerTags(FGameplayTagContainer& OutTags) const;
+
+	/** Activates, pauses or releases every gated layer for the current OwnerTags */
+	void ApplyOwnerTags();
+
+	/** AddTree path of setups with a Processor */
+	bool AddProcessorLayer(const FParallelBehaviorSetup& InSetup);
+
+	/** Adds a pause reason, pausing the tree's logic if it was running */
+	void AddPauseReason(FParallelBehaviorRuntime& InRuntime, EParallelBehaviorPauseReason InReason);
+
+	/** Clears a pause reason, resuming the tree's logic once no reason is left */
+	void RemovePauseReason(FParallelBehaviorRuntime& InRuntime, EParallelBehaviorPauseReason InReason);
+
+	/** Pauses/resumes the runtime and picks its tick interval according to CurrentLOD */
+	void ApplyLOD(FParallelBehaviorRuntime& InRuntime);
+
+	/** Hands the tree to the managed tick scheduler with the given interval, the setup's TickInterval is left alone */
+	bool ApplyTickInterval(FParallelBehaviorRuntime& InRuntime, float InTickInterval);
+
+	/** Subsystem of the owning world, nullptr outside of game worlds */
+	UParallelBehaviorSubsystem* GetParallelBehaviorSubsystem() const;
+
+	/** Creates the shared blackboard and starts observing its keys */
+	void InitializeSharedBlackboard();
+
+	/** Stops observing and destroys the shared blackboard */
+	void ReleaseSharedBlackboard();
+
+	/**
+	 * Source key -> layer key lookup for the given layer asset, built on first use.
+	 *
+	 * @param InOutRoutes Cache of the source blackboard (SharedKeyRoutes or SquadKeyRoutes).
+	 */
+	static const TArray<FBlackboard::FKey>& GetKeyRoutes(TMap<TObjectKey<UBlackboardData>, TArray<FBlackboard::FKey>>& InOutRoutes,
+		const UBlackboardData& InSourceAsset, const TArray<FName>& InKeyFilter, const UBlackboardData& InLayerAsset);
+
+	/** Copies every routed value of a source blackboard into a layer blackboard */
+	static void CopyRoutedValues(const UBlackboardComponent& InSource, TConstArrayView<FBlackboard::FKey> InRoutes,
+		UBlackboardComponent& InLayerBlackboard);
+
+	/** Copies a changed source value into every layer with a matching key */
+	void MirrorKey(const UBlackboardComponent& InSource, FBlackboard::FKey InKey,
+		TMap<TObjectKey<UBlackboardData>, TArray<FBlackboard::FKey>>& InOutRoutes, const TArray<FName>& InKeyFilter);
+
+	/** Copies every mirrored shared and squad value into a layer blackboard */
+	void SyncSharedValues(UBlackboardComponent& InLayerBlackboard);
+
+	/** Mirrors a changed shared value into every layer */
+	EBlackboardNotificationResult OnSharedKeyChanged(const UBlackboardComponent& InBlackboard, FBlackboard::FKey InKey);
+
+	/** Starts observing the setup's WakeKeys on a layer blackboard */
+	void RegisterWakeKeys(UBlackboardComponent& InBlackboard, const FParallelBehaviorSetup& InSetup);
+
+	/** Wakes the layer owning the blackboard if it sleeps */
+	EBlackboardNotificationResult OnWakeKeyChanged(const UBlackboardComponent& InBlackboard, FBlackboard::FKey InKey);
+
+	/** Lets a sleeping layer tick again */
+	void WakeRuntime(FParallelBehaviorRuntime& InRuntime);
+
+	/** Gives the layer a message slot and subscribes it to its MessageTags */
+	void AssignMessageSlot(FParallelBehaviorRuntime& InRuntime);
+
+	/** Drops the layer's pending messages, subscriptions and decorator watchers and frees its slot */
+	void ReleaseMessageSlot(FParallelBehaviorRuntime& InRuntime);
+
+	/** Drops the oldest message, even if some recipients did not receive it */
+	void DropOldestMessage();
+
+	/** Frees ring entries at the head that every recipient has received */
+	void CompactMessages();
+
+	/** Brings LayerSummary in line with the running layers, only changed items are marked dirty */
+	void UpdateLayerSummary();
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PostInitProperties() override;
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext InSaveContext) override;
+	virtual EDataValidationResult IsDataValid(FDataValidationContext& InContext) const override;
+#endif
+
+public:
+#if WITH_EDITOR
+	/**
+	 * Checks a layer set for layers without tree or processor, unloadable trees, processor fragments of the
+	 * wrong type and duplicate Ids. A tree without blackboard is an error when the layer uses a feature needing
+	 * one (initial values, wake keys, tick condition, shared or squad keys), a warning without lean layers.
+	 *
+	 * @param InOutIds Ids seen so far, layers are checked for duplicates against them and added.
+	 * @param bInLeanLayers Blackboard-less trees are intended, see bLeanLayers.
+	 * @param bInRoutesKeys The manager mirrors shared or squad keys into its layers.
+	 */
+	static EDataValidationResult ValidateSetups(TConstArrayView<FParallelBehaviorSetup> InSetups, const FString& InSetName,
+		TSet<FName>& InOutIds, FDataValidationContext& InContext, bool bInLeanLayers = false, bool bInRoutesKeys = false);
+
+	/** Runs IsDataValid on an object being cooked and logs every issue as an error, so malformed layers fail the cook */
+	static void ValidateForCook(const UObject& InObject);
+#endif
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+public:
+	/** Current coarse state of a layer on the server */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Manage")
+	EParallelBehaviorLayerState GetLayerState(FName InId) const;
+
+	/**
+	 * Replicated state of a layer, usable on clients when bReplicateLayerSummary is set.
+	 * Lags behind GetLayerState by up to LayerSummaryUpdateInterval plus the net update delay.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Replication")
+	EParallelBehaviorLayerState GetReplicatedLayerState(FName InId) const;
+
+	/** Every layer of the replicated summary */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Replication")
+	const TArray<FParallelBehaviorLayerSummaryItem>& GetReplicatedLayers() const { return LayerSummary.Items; }
 
 public:
 	/**
@@ -123,10 +916,85 @@ public:
 	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
 	bool AddTree(const FParallelBehaviorSetup& InSetup);
 
+	/**
+	 * Streams in the behavior tree asset of the given setup and starts the tree once loading finishes.
+	 *
+	 * If the asset is already resident the tree is started immediately. OnTreesStarted is broadcast
+	 * after the tree has been started.
+	 *
+	 * @param InSetup Configuration data defining the behavior tree asset and its ID.
+	 * @return true if the request was accepted (valid asset path), false otherwise.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
+	bool AddTreeAsync(const FParallelBehaviorSetup& InSetup);
+
+	/**
+	 * Streams in the behavior tree assets of all given setups through a single FStreamableManager
+	 * request and starts every tree once the whole batch has finished loading.
+	 *
+	 * Setups whose assets are already resident do not issue any load. OnTreesStarted is broadcast
+	 * once per batch with the IDs of the trees that were started.
+	 *
+	 * @param InSetups Configuration data for every tree to add.
+	 * @return true if at least one setup had a valid asset path, false otherwise.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
+	bool AddTreesAsync(const TArray<FParallelBehaviorSetup>& InSetups);
+
+	/**
+	 * Queues a tree in the world spawn queue, started on a later frame within the spawn budget.
+	 * Setups with a higher SpawnPriority are started first, equal priorities in queue order.
+	 * Falls back to AddTree when no subsystem is available.
+	 *
+	 * @param InSetup Configuration of the tree to start.
+	 * @return true if the setup was queued or started.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
+	bool QueueTree(const FParallelBehaviorSetup& InSetup);
+
+	/**
+	 * Fragment of a processor layer, valid until a layer of the same processor is added or removed anywhere in the world.
+	 *
+	 * @return nullptr if no processor layer with that Id runs or its fragment is not a T.
+	 */
+	template <typename T>
+	T* GetProcessorFragment(const FName& InId) const
+	{
+		const UScriptStruct* fragmentType = nullptr;
+		uint8* fragment = FindProcessorFragment(InId, fragmentType);
+		return fragment != nullptr && fragmentType->IsChildOf(T::StaticStruct()) ? reinterpret_cast<T*>(fragment) : nullptr;
+	}
+
+	/** Untyped GetProcessorFragment */
+	uint8* FindProcessorFragment(const FName& InId, const UScriptStruct*& OutType) const;
+
+	/** Whether a processor layer with the given Id is running */
+	bool IsProcessorLayer(const FName& InId) const { return ProcessorLayers.Contains(InId); }
+
+	/** Number of running processor layers */
+	int32 GetNumProcessorLayers() const { return ProcessorLayers.Num(); }
+
+	/** Starts a setup leaving the spawn queue, called by UParallelBehaviorSubsystem */
+	void StartQueuedTree(const FParallelBehaviorSetup& InSetup);
+
+	/** Hands every self-ticking tree layer over to the subsystem scheduler, used by step mode */
+	void UseManagedTickForAllTrees();
+
+	/** Drops every setup of this manager still waiting in the spawn queue */
+	void CancelQueuedTrees();
+
+	/** Number of setups of this manager still waiting in the spawn queue */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Manage")
+	int32 GetNumQueuedTrees() const { return NumQueuedTrees; }
+
+	/** Whether every default tree is loaded and started, OnBehaviorReady has been broadcast */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Manage")
+	bool IsBehaviorReady() const { return bBehaviorReady; }
+
 	/**
 	 * Retrieves the Behavior Tree component associated with the specified identifier.
 	 * 
-	 * Only allowed on authority. Searches through all managed parallel behavior tree instances.
+	 * Only allowed on authority. Constant time lookup through the ID index. Misses are logged at Verbose.
 	 * 
 	 * @param InId The unique identifier of the behavior tree instance to retrieve.
 	 * @return Pointer to the UBehaviorTreeComponent if found, nullptr if no tree with that ID exists.
@@ -134,6 +1002,14 @@ public:
 	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
 	UBehaviorTreeComponent* GetTree(const FName& InId) const;
 
+	/**
+	 * Same as GetTree() but never logs, meant for hot paths that probe for optional layers.
+	 *
+	 * @param InId The unique identifier of the behavior tree instance to retrieve.
+	 * @return Pointer to the UBehaviorTreeComponent if found, nullptr otherwise.
+	 */
+	UBehaviorTreeComponent* FindTree(const FName& InId) const;
+
 	/**
 	 * Stops execution of the behavior tree instance with the given ID.
 	 * 
@@ -142,9 +1018,10 @@ public:
 	 * Safe to call on non-existent IDs (no-op).
 	 * 
 	 * @param InId The unique identifier of the behavior tree instance to stop.
+	 * @param InStopMode Default uses the layer setup's StopMode.
 	 */
 	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
-	void StopTree(const FName& InId);
+	void StopTree(const FName& InId, EParallelBehaviorStopMode InStopMode = EParallelBehaviorStopMode::Default);
 
 	/**
 	 * Restarts the behavior tree instance with the given ID.
@@ -158,27 +1035,338 @@ public:
 	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
 	void RestartTree(const FName& InId);
 
+	/**
+	 * Suspends the tree with the given ID without tearing it down.
+	 *
+	 * Ticking stops and the active node, latent task state and Blackboard are kept, ResumeTree picks up
+	 * exactly where it left off. Blackboard observer notifications are queued while paused.
+	 *
+	 * @param InId The unique identifier of the behavior tree instance to pause.
+	 * @return true if the tree exists.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
+	bool PauseTree(const FName& InId);
+
+	/**
+	 * Resumes a tree paused by PauseTree. It stays paused while another reason (LOD, world pause) holds it.
+	 *
+	 * @param InId The unique identifier of the behavior tree instance to resume.
+	 * @return true if the tree exists.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
+	bool ResumeTree(const FName& InId);
+
+	/** Whether the tree with the given ID is paused for any reason */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Manage")
+	bool IsTreePaused(const FName& InId) const;
+
+	/**
+	 * Suspends every tree of this manager (cutscenes, dormant agents...), trees added while paused start paused.
+	 * See PauseTree.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
+	void PauseAll();
+
+	/** Resumes every tree suspended by PauseTree or PauseAll */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Manage")
+	void ResumeAll();
+
+	/**
+	 * Puts the tree with the given ID to sleep: it is not ticked at all until woken by a change of one of
+	 * the setup's WakeKeys, a NotifyGameplayEvent matching its WakeTags, or WakeTree.
+	 *
+	 * Unlike PauseTree, Blackboard observers stay active, so execution requests of Blackboard decorators
+	 * are processed right after waking. Natively ticking trees are handed over to the managed tick scheduler.
+	 * Usually entered from the tree itself through the Parallel Sleep task.
+	 *
+	 * @param InId The unique identifier of the behavior tree instance to put to sleep.
+	 * @return true if the tree sleeps.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Sleep")
+	bool SleepTree(const FName& InId);
+
+	/**
+	 * Wakes a sleeping tree, it is ticked again on the next frame.
+	 *
+	 * @param InId The unique identifier of the behavior tree instance to wake.
+	 * @return true if the tree was sleeping.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Sleep")
+	bool WakeTree(const FName& InId);
+
+	/** Whether the tree with the given ID sleeps */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Sleep")
+	bool IsTreeSleeping(const FName& InId) const;
+
+	/**
+	 * Wakes every sleeping tree whose setup lists a tag matching InEventTag in its WakeTags.
+	 *
+	 * @return Number of woken trees.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Sleep")
+	int32 NotifyGameplayEvent(FGameplayTag InEventTag);
+
+	/**
+	 * Re-reads the owner tags and activates, pauses or releases every layer with an activation or deactivation query.
+	 * Tags are read from the owner, else the pawn, implementing IGameplayTagAssetInterface. Nothing polls them,
+	 * call this from whatever changes them. Without a tag source the tags set through SetOwnerTags are re-applied.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Activation")
+	void NotifyOwnerTagsChanged();
+
+	/** Replaces the owner tags the activation queries are evaluated against and applies them */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Activation")
+	void SetOwnerTags(const FGameplayTagContainer& InTags);
+
+	/**
+	 * Applies the change of a single owner tag. Matches the ability system's tag count delegates, e.g.
+	 * AbilitySystem->RegisterGenericGameplayTagEvent().AddUObject(Manager, &UParallelBehaviorManagerComponent::HandleOwnerTagChanged)
+	 *
+	 * @param InNewCount Stack count of the tag, 0 once it was removed.
+	 */
+	void HandleOwnerTagChanged(const FGameplayTag InTag, int32 InNewCount);
+
+	/** Owner tags the activation queries are currently evaluated against */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Activation")
+	const FGameplayTagContainer& GetOwnerTags() const { return OwnerTags; }
+
+	/** Whether the layer with the given ID waits for its activation query without any components */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Activation")
+	bool IsLayerInactive(FName InId) const;
+
+	/** ID of the running tree driven by the given component, NAME_None if it is not one of ours */
+	FName FindTreeId(const UBehaviorTreeComponent* InTreeComponent) const;
+
+	/**
+	 * Posts a message to one layer, or to every layer subscribed to its Type when no target is given.
+	 * Sleeping recipients are woken and their Parallel Has Message decorators re-evaluated.
+	 * Copies the message into a fixed-size ring buffer, the oldest message is dropped once it is full.
+	 *
+	 * @param InMessage Message to post.
+	 * @param InTargetLayer Id of the receiving layer, NAME_None delivers by InMessage.Type.
+	 * @return Number of recipients.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Messages")
+	int32 PostMessage(const FParallelBehaviorMessage& InMessage, FName InTargetLayer = NAME_None);
+
+	/**
+	 * Whether a message is waiting for a layer.
+	 *
+	 * @param InType Only messages of this type (or its child tags), an empty tag matches every message.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Messages")
+	bool HasMessage(FName InLayerId, FGameplayTag InType) const;
+
+	/**
+	 * Takes the oldest message waiting for a layer.
+	 *
+	 * @param InType Only messages of this type (or its child tags), an empty tag matches every message.
+	 * @param OutMessage Received message.
+	 * @return false if no message was waiting.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Messages")
+	bool ReceiveMessage(FName InLayerId, FGameplayTag InType, FParallelBehaviorMessage& OutMessage);
+
+	/** Message slot of a layer, INDEX_NONE if the layer is unknown or cannot receive messages */
+	int32 GetMessageSlot(const FName& InLayerId) const;
+
+	/** HasMessage by message slot */
+	bool HasMessageForSlot(int32 InSlot, const FGameplayTag& InType) const;
+
+	/** ReceiveMessage by message slot */
+	bool ReceiveMessageForSlot(int32 InSlot, const FGameplayTag& InType, FParallelBehaviorMessage& OutMessage);
+
+	/** Requests a re-evaluation of the decorator in the given tree whenever its layer receives a message */
+	void AddMessageWatcher(UBehaviorTreeComponent& InTree, const UBTDecorator& InDecorator);
+
+	/** Undoes AddMessageWatcher */
+	void RemoveMessageWatcher(const UBehaviorTreeComponent& InTree, const UBTDecorator& InDecorator);
+
+	/**
+	 * Changes how often the tree with the given ID ticks.
+	 *
+	 * A tree that was ticking on its own is handed over to the managed tick scheduler and stays there,
+	 * setting the interval back to 0 ticks it every frame through the scheduler.
+	 *
+	 * @param InId The unique identifier of the behavior tree instance.
+	 * @param InTickInterval Seconds between ticks, 0 ticks every frame.
+	 * @return true if the tree was found.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Tick")
+	bool SetTreeTickInterval(const FName& InId, float InTickInterval);
+
+	/**
+	 * Changes the managed tick priority of the tree with the given ID.
+	 *
+	 * @param InId The unique identifier of the behavior tree instance.
+	 * @param InPriority Higher priority trees are ticked first when the budget runs out.
+	 * @return true if the tree was found.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Tick")
+	bool SetTreePriority(const FName& InId, int32 InPriority);
+
+	/**
+	 * Applies a LOD level to every layer: layers whose MaxLOD is below it are paused (state kept),
+	 * the others resume and switch to their LOD tick interval.
+	 *
+	 * Called by UParallelBehaviorSubsystem when bEnableLOD is set, can also be driven by a custom
+	 * significance metric.
+	 *
+	 * @param InLOD LOD level, 0 being the most relevant.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "LOD")
+	void SetLOD(int32 InLOD);
+
+	/** LOD level currently applied to the layers */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "LOD")
+	int32 GetLOD() const { return CurrentLOD; }
+
+	/** LOD level matching the given distance according to LODDistances */
+	int32 GetLODForDistance(float InDistance) const;
+
+	/**
+	 * Blackboard shared by every layer of this manager, nullptr if no SharedBlackboardAsset is set.
+	 * Values written here are mirrored into every layer blackboard key with the same name and type.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, BlueprintPure, Category = "Shared Blackboard")
+	UBlackboardComponent* GetSharedBlackboard() const { return SharedBlackboard; }
+
+	/**
+	 * Joins a squad, leaving the current one. Squad values matching SquadKeys are copied into every layer
+	 * right away and mirrored on every later squad write.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Squad")
+	void JoinSquad(UParallelBehaviorSquad* InSquad);
+
+	/** Stops mirroring the squad, layer values keep their last mirrored state */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Squad")
+	void LeaveSquad();
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Squad")
+	UParallelBehaviorSquad* GetSquad() const { return Squad; }
+
+	/** Mirrors a changed squad value into every layer, called by UParallelBehaviorSquad */
+	void MirrorSquadKey(const UBlackboardComponent& InSquadBlackboard, FBlackboard::FKey InKey);
+
+	/**
+	 * Writes a set of values into the blackboard of every running tree (or of the listed trees) as one batch.
+	 *
+	 * Observer notifications of each blackboard are held until all values are written, so every tree
+	 * re-evaluates at most once per batch instead of once per key. Key IDs are resolved through
+	 * FParallelBehaviorAssetCache once per blackboard asset. Keys missing from a tree's blackboard are skipped.
+	 *
+	 * @param InValues Key/value pairs to write.
+	 * @param InTreeIds Only write into these trees, empty writes into every running tree.
+	 * @return Number of blackboards that received at least one value.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Blackboard")
+	int32 SetValuesOnTrees(const TArray<FParallelBehaviorBlackboardValue>& InValues, const TArray<FName>& InTreeIds);
+
+	/**
+	 * Writes a batch of values into one blackboard with observer notifications coalesced.
+	 *
+	 * @param bInHoldNotifications Pause/resume notifications around the batch. Pass false for blackboards
+	 *                             of paused trees, those already queue their notifications until resumed.
+	 * @return Number of written keys.
+	 */
+	static int32 ApplyValuesBatched(UBlackboardComponent& InBlackboard, TConstArrayView<FParallelBehaviorBlackboardValue> InValues,
+		bool bInHoldNotifications = true);
+
+	/** Pauses or resumes every layer on behalf of UParallelBehaviorSubsystem::SetWorldPaused */
+	void SetPausedByWorld(bool bInPaused);
+
+	/** Whether the subsystem should evaluate LOD for this manager */
+	bool IsLODEnabled() const { return bEnableLOD; }
+
 	/**
 	 * Removes and destroys the behavior tree instance with the specified ID.
 	 * 
-	 * Stops the tree (if running), destroys its UBehaviorTreeComponent, and removes it from the
-	 * internal tracking array. Can be called from anywhere (client/server), but typically used
+	 * Stops the tree (if running), destroys (or pools) its UBehaviorTreeComponent, and swap-removes it
+	 * from the internal tracking array, so the order of GetRunningTrees() is not preserved. Can be called from anywhere (client/server), but typically used
 	 * after authority has stopped/restarted as needed.
 	 * 
 	 * @param Id The unique identifier of the behavior tree instance to remove.
+	 * @param StopMode Default uses the layer setup's StopMode.
 	 * @return true if a tree with the given ID was found and removed, false otherwise.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Manage")
-	bool RemoveTree(FName Id);
+	bool RemoveTree(FName Id, EParallelBehaviorStopMode StopMode = EParallelBehaviorStopMode::Default);
 
 	/**
 	 * Removes and destroys all currently managed parallel behavior tree instances.
 	 * 
 	 * Stops every running tree, destroys their components, and clears the internal array.
 	 * Useful for cleanup on death, level transition, or when fully resetting AI logic.
+	 *
+	 * @param StopMode Default uses each layer setup's StopMode.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Manager")
-	void RemoveAllTrees();
+	void RemoveAllTrees(EParallelBehaviorStopMode StopMode = EParallelBehaviorStopMode::Default);
+
+	/**
+	 * Bulk variant of RemoveAllTrees for mass deaths and level transitions.
+	 *
+	 * Trees are force-stopped, or not stopped at all while the world tears down (no task abort callbacks).
+	 * Pairs go back to the pool and the ones that do not fit are destroyed by the subsystem over the next
+	 * frames. Components of an owner being destroyed are left to the owner's own teardown.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Manager")
+	void TeardownTrees();
+
+	/**
+	 * Creates stopped component pairs for the given setup ahead of time so later AddTree calls
+	 * with the same asset do not allocate. Meant to be called during loading screens.
+	 *
+	 * The asset is loaded synchronously if needed. The pool never grows past MaxPooledPairsPerAsset.
+	 *
+	 * @param InSetup Setup whose behavior tree asset the pairs are created for.
+	 * @param InCount Number of pairs to create.
+	 * @return Number of pairs actually added to the pool.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Pool")
+	int32 PrewarmPool(const FParallelBehaviorSetup& InSetup, int32 InCount);
+
+	/**
+	 * Destroys every pooled component pair, spread over the next frames by the subsystem.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Pool")
+	void EmptyPool();
+
+	/** Number of component pairs currently waiting in the pool */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Pool")
+	int32 GetPooledPairCount() const { return ComponentPool.Num(); }
+
+	/**
+	 * State and cost of every running layer, meant for in-game dashboards.
+	 * Tick timings are only available for layers using managed tick.
+	 *
+	 * @return One entry per running layer, in GetRunningTrees() order.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Debug")
+	TArray<FParallelBehaviorLayerStats> GetLayerStats() const;
+
+	/**
+	 * Captures the blackboard values and state of every layer, processor layers included.
+	 * Only plain values, object/class references and strings are captured.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Manage")
+	FParallelBehaviorSnapshot CaptureSnapshot() const;
+
+	/**
+	 * Starts every layer of a snapshot with its captured blackboard values and state, reusing pooled pairs.
+	 * Layers whose Id is already running are skipped.
+	 *
+	 * @return Number of layers started.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Manage")
+	int32 RestoreSnapshot(const FParallelBehaviorSnapshot& InSnapshot);
+
+	/** Key used for bPersistAcrossStreaming */
+	FName GetSnapshotKey() const;
+
+	/** Estimated memory used by this manager's layers, pool and messages, see pb.MemReport */
+	UFUNCTION(BlueprintCallable, Category = "Debug")
+	FParallelBehaviorMemoryStats GetMemoryStats() const;
 
 	/**
 	 * @brief Get the Pawn this manager is controlling.
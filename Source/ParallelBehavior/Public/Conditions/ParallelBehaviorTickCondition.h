@@ -0,0 +1,70 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "ParallelBehaviorTickCondition.generated.h"
+
+class UBlackboardComponent;
+
+/**
+ * @class UParallelBehaviorTickCondition
+ * @brief Pure, thread-safe gate deciding whether a managed layer needs its tick this frame
+ *
+ * Conditions of layers marked bThreadSafe are evaluated by UParallelBehaviorSubsystem on worker threads
+ * for every due layer of the world at once. Layers whose condition fails skip the tick and keep
+ * accumulating delta time, the others are ticked on the game thread as usual.
+ *
+ * IsSatisfied() runs off the game thread: it may only read the given blackboard and its own properties.
+ */
+UCLASS(Abstract, EditInlineNew, DefaultToInstanced, CollapseCategories)
+class PARALLELBEHAVIOR_API UParallelBehaviorTickCondition : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Resolves the blackboard keys the condition reads. Called on the game thread when the layer is registered.
+	 *
+	 * @param InAsset Blackboard asset of the layer.
+	 * @param OutKeys Keys later handed to IsSatisfied(), in the order the condition expects them.
+	 */
+	virtual void ResolveKeys(const UBlackboardData& InAsset, TArray<FBlackboard::FKey>& OutKeys) const {}
+
+	/**
+	 * Thread-safe check whether the layer should tick. Must not write anything.
+	 *
+	 * @param InBlackboard Blackboard of the layer.
+	 * @param InKeys Keys resolved by ResolveKeys().
+	 * @return true to tick the layer this frame.
+	 */
+	virtual bool IsSatisfied(const UBlackboardComponent& InBlackboard, TConstArrayView<FBlackboard::FKey> InKeys) const
+	{
+		return true;
+	}
+};
+
+/**
+ * @class UParallelBehaviorTickCondition_Blackboard
+ * @brief Ticks the layer only while a bool key has the expected value, or while an object key is set
+ */
+UCLASS(meta = (DisplayName = "Blackboard Key"))
+class PARALLELBEHAVIOR_API UParallelBehaviorTickCondition_Blackboard : public UParallelBehaviorTickCondition
+{
+	GENERATED_BODY()
+
+public:
+	/** Bool or object key to test */
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	FName KeyName = NAME_None;
+
+	/** Bool keys must equal this value, object keys must be set (true) or empty (false) */
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	bool bExpectedValue = true;
+
+public:
+	virtual void ResolveKeys(const UBlackboardData& InAsset, TArray<FBlackboard::FKey>& OutKeys) const override;
+	virtual bool IsSatisfied(const UBlackboardComponent& InBlackboard, TConstArrayView<FBlackboard::FKey> InKeys) const override;
+};
\ No newline at end of file
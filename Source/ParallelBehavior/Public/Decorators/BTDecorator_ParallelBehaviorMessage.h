@@ -0,0 +1,38 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTDecorator.h"
+#include "GameplayTagContainer.h"
+#include "BTDecorator_ParallelBehaviorMessage.generated.h"
+
+/**
+ * @class UBTDecorator_ParallelBehaviorMessage
+ * @brief Passes while a message of the given type is waiting for this layer
+ *
+ * Re-evaluated whenever a message is posted to the layer, so observer aborts react immediately.
+ * Consume the message with the Parallel Receive Message task.
+ */
+UCLASS(meta = (DisplayName = "Parallel Has Message"))
+class PARALLELBEHAVIOR_API UBTDecorator_ParallelBehaviorMessage : public UBTDecorator
+{
+	GENERATED_BODY()
+
+public:
+	UBTDecorator_ParallelBehaviorMessage();
+
+	/** Message type to wait for (child tags match too), empty matches every message */
+	UPROPERTY(EditAnywhere, Category = "Message")
+	FGameplayTag MessageType;
+
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+};
\ No newline at end of file
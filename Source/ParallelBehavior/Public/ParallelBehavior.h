@@ -13,4 +13,8 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	/** Keeps the asset cache in sync with blackboard assets edited at runtime */
+	FDelegateHandle BlackboardKeysUpdatedHandle;
 };
@@ -0,0 +1,70 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "ParallelBehaviorArchetype.generated.h"
+
+struct FStreamableHandle;
+
+/**
+ * @class UParallelBehaviorArchetype
+ * @brief Layer set defined once and shared by every manager referencing it
+ *
+ * Tree assets are streamed in by a single request per archetype and blackboard layouts are resolved once,
+ * managers spawned afterwards only create and start their component pairs.
+ */
+UCLASS(BlueprintType)
+class PARALLELBEHAVIOR_API UParallelBehaviorArchetype : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Layers started by every manager using this archetype (assets, priorities, tick rates, LOD rules, initial values) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Behavior", meta = (TitleProperty = "Id"))
+	TArray<FParallelBehaviorSetup> Layers;
+
+	/** Start streaming the layer trees as soon as the archetype is loaded, e.g. together with the level referencing it */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loading")
+	bool bPreloadTrees = true;
+
+public:
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext InSaveContext) override;
+	virtual EDataValidationResult IsDataValid(FDataValidationContext& InContext) const override;
+#endif
+
+	/** Every layer tree is loaded and its blackboard layout resolved */
+	UFUNCTION(BlueprintPure, Category = "Parallel Behavior")
+	bool IsResolved() const { return bResolved; }
+
+	/**
+	 * Streams in every layer tree, shared by all callers, with a single request.
+	 *
+	 * @param InOnResolved Called once the archetype is resolved, right away if it already is.
+	 * @return False if the archetype has no layer to run.
+	 */
+	bool ResolveAsync(FSimpleDelegate InOnResolved);
+
+	/** Loads every layer tree on the game thread, prefer ResolveAsync on the gameplay path */
+	bool ResolveSynchronous();
+
+private:
+	/** Keeps the loaded trees referenced and resolves their blackboard layouts */
+	void FinishResolve();
+
+	/** Trees of Layers, held while the archetype is loaded so they stay resident */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UBehaviorTree>> ResolvedTrees;
+
+	/** In-flight streaming request shared by every caller of ResolveAsync */
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	/** Callbacks waiting for LoadHandle */
+	TArray<FSimpleDelegate> PendingCallbacks;
+
+	bool bResolved = false;
+};
\ No newline at end of file
@@ -0,0 +1,80 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "BehaviorTree/BlackboardData.h"
+
+class UBehaviorTree;
+
+/**
+ * @struct FParallelBehaviorBlackboardLayout
+ * @brief Key IDs of a blackboard asset resolved once and shared by every instance
+ */
+struct PARALLELBEHAVIOR_API FParallelBehaviorBlackboardLayout
+{
+	/** Key ID per key name, including keys inherited from parent assets */
+	TMap<FName, FBlackboard::FKey> KeyIds;
+
+	/** ID of FBlackboard::KeySelf, InvalidKey if the asset has none */
+	FBlackboard::FKey SelfKey = FBlackboard::InvalidKey;
+
+	/** Bytes of value memory a blackboard component allocates for the asset */
+	int32 ValueMemorySize = 0;
+
+	/** Keys whose value memory is copied byte for byte into snapshots (plain values and weak object references) */
+	TArray<FBlackboard::FKey> SnapshotKeys;
+
+	/** Value size of each SnapshotKeys entry */
+	TArray<uint16> SnapshotKeySizes;
+
+	/** Sum of SnapshotKeySizes, size of the raw part of a layer snapshot */
+	int32 SnapshotSize = 0;
+
+	/** String keys, snapshotted by value */
+	TArray<FBlackboard::FKey> StringKeys;
+
+	/** Cached key ID for a key name, FBlackboard::InvalidKey if the asset has no such key */
+	FBlackboard::FKey Find(const FName& InKeyName) const
+	{
+		const FBlackboard::FKey* key = KeyIds.Find(InKeyName);
+		return key != nullptr ? *key : FBlackboard::InvalidKey;
+	}
+};
+
+/**
+ * @class FParallelBehaviorAssetCache
+ * @brief Game thread cache of per-asset data the managers would otherwise re-derive for every tree instance
+ */
+class PARALLELBEHAVIOR_API FParallelBehaviorAssetCache
+{
+public:
+	/** Process wide instance */
+	static FParallelBehaviorAssetCache& Get();
+
+	/** Layout of the given blackboard asset, resolved on first use */
+	const FParallelBehaviorBlackboardLayout& GetLayout(const UBlackboardData& InAsset);
+
+	/** Layout of the blackboard used by the given tree, nullptr if the tree has no blackboard asset */
+	const FParallelBehaviorBlackboardLayout* GetLayout(const UBehaviorTree& InTree);
+
+	/** Cached key ID for a key name, FBlackboard::InvalidKey if the asset has no such key */
+	FBlackboard::FKey GetKeyID(const UBlackboardData& InAsset, const FName& InKeyName);
+
+	/**
+	 * Resolves a list of key names in one go.
+	 *
+	 * @param OutKeys Key ID per input name, FBlackboard::InvalidKey where the asset has no such key.
+	 */
+	void ResolveKeys(const UBlackboardData& InAsset, TConstArrayView<FName> InKeyNames, TArray<FBlackboard::FKey>& OutKeys);
+
+	/** Drops cached data of one asset, e.g. after its keys were edited */
+	void Invalidate(const UBlackboardData* InAsset);
+
+	/** Drops every cached entry */
+	void Reset();
+
+private:
+	TMap<TObjectKey<UBlackboardData>, FParallelBehaviorBlackboardLayout> Layouts;
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BlackboardData.h"
+
+class UBlackboardComponent;
+
+/**
+ * @struct FParallelBehaviorBlackboardUtils
+ * @brief Helpers to move values between blackboards that use different assets
+ */
+struct PARALLELBEHAVIOR_API FParallelBehaviorBlackboardUtils
+{
+	/**
+	 * Copies the value of a key into a key of another blackboard.
+	 *
+	 * Both keys must use the same key type. Observers of the target are notified only if the value changed.
+	 *
+	 * @return true if the value was copied, false if the key types differ or are not supported.
+	 */
+	static bool CopyValue(const UBlackboardComponent& InSource, FBlackboard::FKey InSourceKey,
+		UBlackboardComponent& InTarget, FBlackboard::FKey InTargetKey);
+
+	/**
+	 * Builds a lookup from every key of the source asset to the key with the same name and type in the target asset.
+	 *
+	 * @param InSourceAsset Asset whose key IDs index the result.
+	 * @param InTargetAsset Asset whose key IDs are stored in the result.
+	 * @param InKeyFilter Only route these key names, empty routes every key.
+	 * @param OutRoutes Target key per source key ID, FBlackboard::InvalidKey where no match exists.
+	 * @return true if at least one key was routed.
+	 */
+	static bool BuildKeyRoutes(const UBlackboardData& InSourceAsset, const UBlackboardData& InTargetAsset,
+		const TArray<FName>& InKeyFilter, TArray<FBlackboard::FKey>& OutRoutes);
+};
\ No newline at end of file
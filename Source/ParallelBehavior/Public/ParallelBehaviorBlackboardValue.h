@@ -0,0 +1,91 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "ParallelBehaviorBlackboardValue.generated.h"
+
+class UBlackboardComponent;
+
+/**
+ * @enum EParallelBehaviorValueType
+ * @brief Blackboard key type a FParallelBehaviorBlackboardValue writes
+ */
+UENUM(BlueprintType)
+enum class EParallelBehaviorValueType : uint8
+{
+	Object,
+	Class,
+	Bool,
+	Int,
+	Float,
+	Enum,
+	Name,
+	String,
+	Vector,
+	Rotator,
+};
+
+/**
+ * @struct FParallelBehaviorBlackboardValue
+ * @brief Typed value for a blackboard key, addressed by key name
+ */
+USTRUCT(BlueprintType)
+struct PARALLELBEHAVIOR_API FParallelBehaviorBlackboardValue
+{
+	GENERATED_BODY()
+
+public:
+	/** Name of the blackboard key to write */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName Key = NAME_None;
+
+	/** Which of the value fields is used */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EParallelBehaviorValueType Type = EParallelBehaviorValueType::Object;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Object", EditConditionHides))
+	TObjectPtr<UObject> ObjectValue = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Class", EditConditionHides))
+	TObjectPtr<UClass> ClassValue = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Bool", EditConditionHides))
+	bool BoolValue = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Int", EditConditionHides))
+	int32 IntValue = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Float", EditConditionHides))
+	float FloatValue = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Enum", EditConditionHides))
+	uint8 EnumValue = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Name", EditConditionHides))
+	FName NameValue = NAME_None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::String", EditConditionHides))
+	FString StringValue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Vector", EditConditionHides))
+	FVector VectorValue = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "Type == EParallelBehaviorValueType::Rotator", EditConditionHides))
+	FRotator RotatorValue = FRotator::ZeroRotator;
+
+public:
+	/**
+	 * Writes the value into an already resolved key.
+	 *
+	 * @return true if the key type matched and the value was written.
+	 */
+	bool ApplyTo(UBlackboardComponent& InBlackboard, FBlackboard::FKey InKey) const;
+
+	static FParallelBehaviorBlackboardValue MakeObject(FName InKey, UObject* InValue);
+	static FParallelBehaviorBlackboardValue MakeBool(FName InKey, bool bInValue);
+	static FParallelBehaviorBlackboardValue MakeInt(FName InKey, int32 InValue);
+	static FParallelBehaviorBlackboardValue MakeFloat(FName InKey, float InValue);
+	static FParallelBehaviorBlackboardValue MakeVector(FName InKey, const FVector& InValue);
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Config.h"
+
+/** Layer debugging (tick history, gameplay debugger category, layer trace events), compiled out of shipping builds */
+#ifndef PARALLEL_BEHAVIOR_DEBUG
+#define PARALLEL_BEHAVIOR_DEBUG !UE_BUILD_SHIPPING
+#endif
+
+/** Layer tick events on the ParallelBehavior trace channel */
+#define PARALLEL_BEHAVIOR_TRACE_ENABLED (PARALLEL_BEHAVIOR_DEBUG && UE_TRACE_ENABLED)
+
+class UBehaviorTreeComponent;
+class UParallelBehaviorManagerComponent;
+
+#if PARALLEL_BEHAVIOR_DEBUG
+
+/**
+ * @struct FParallelBehaviorTickHistory
+ * @brief Fixed size ring buffer of the last managed tick costs of one layer
+ *
+ * Storage is inline, recording a tick never allocates and the oldest sample is overwritten.
+ */
+struct FParallelBehaviorTickHistory
+{
+	static constexpr int32 Capacity = 32;
+
+	/** Records the cost of one tick */
+	void Push(uint64 InCycles)
+	{
+		Cycles[Head] = InCycles;
+		Head = (Head + 1) % Capacity;
+		Count = FMath::Min(Count + 1, Capacity);
+	}
+
+	int32 Num() const { return Count; }
+
+	/** Sample by age, 0 is the most recent tick */
+	uint64 GetCyclesAgo(int32 InAge) const
+	{
+		check(InAge >= 0 && InAge < Count);
+		return Cycles[(Head - 1 - InAge + Capacity) % Capacity];
+	}
+
+	/** Most expensive recorded tick */
+	uint64 GetPeakCycles() const
+	{
+		uint64 peak = 0;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			peak = FMath::Max(peak, Cycles[i]);
+		}
+		return peak;
+	}
+
+	void Reset()
+	{
+		Head = 0;
+		Count = 0;
+	}
+
+private:
+	uint64 Cycles[Capacity] = {};
+	int32 Head = 0;
+	int32 Count = 0;
+};
+
+#endif // PARALLEL_BEHAVIOR_DEBUG
+
+#if PARALLEL_BEHAVIOR_TRACE_ENABLED
+
+/**
+ * @struct FParallelBehaviorTrace
+ * @brief Writes layer events to the ParallelBehavior trace channel, read them in Insights with -trace=ParallelBehavior
+ */
+struct PARALLELBEHAVIOR_API FParallelBehaviorTrace
+{
+	/** One managed tick of a layer: timing, owner and the node active after the tick */
+	static void OutputLayerTick(const UParallelBehaviorManagerComponent* InManager, const FName& InLayerId,
+		const UBehaviorTreeComponent& InTree, uint64 InStartCycles, uint64 InCycles);
+
+	/** A layer was added to or removed from a manager */
+	static void OutputLayerLifetime(const UParallelBehaviorManagerComponent* InManager, const FName& InLayerId, bool bInAdded);
+};
+
+#define PARALLEL_BEHAVIOR_TRACE_LAYER_TICK(Manager, LayerId, Tree, StartCycles, Cycles) \
+	FParallelBehaviorTrace::OutputLayerTick(Manager, LayerId, Tree, StartCycles, Cycles)
+#define PARALLEL_BEHAVIOR_TRACE_LAYER_LIFETIME(Manager, LayerId, bAdded) \
+	FParallelBehaviorTrace::OutputLayerLifetime(Manager, LayerId, bAdded)
+
+#else
+
+#define PARALLEL_BEHAVIOR_TRACE_LAYER_TICK(...)
+#define PARALLEL_BEHAVIOR_TRACE_LAYER_LIFETIME(...)
+
+#endif // PARALLEL_BEHAVIOR_TRACE_ENABLED
\ No newline at end of file
@@ -0,0 +1,85 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "ParallelBehaviorLayerSummary.generated.h"
+
+class UParallelBehaviorManagerComponent;
+
+/**
+ * @enum EParallelBehaviorLayerState
+ * @brief Coarse state of a layer, as replicated to clients by the layer summary
+ */
+UENUM(BlueprintType)
+enum class EParallelBehaviorLayerState : uint8
+{
+	/** No layer with that Id is running */
+	Inactive,
+	Running,
+	/** Paused for any reason (user, LOD, world) */
+	Paused,
+	Sleeping,
+};
+
+struct FParallelBehaviorLayerSummary;
+
+/**
+ * @struct FParallelBehaviorLayerSummaryItem
+ * @brief Id and coarse state of one layer, a state change replicates a single byte
+ */
+USTRUCT(BlueprintType)
+struct PARALLELBEHAVIOR_API FParallelBehaviorLayerSummaryItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FName Id = NAME_None;
+
+	UPROPERTY(BlueprintReadOnly)
+	EParallelBehaviorLayerState State = EParallelBehaviorLayerState::Inactive;
+
+public:
+	void PreReplicatedRemove(const FParallelBehaviorLayerSummary& InArraySerializer);
+	void PostReplicatedAdd(const FParallelBehaviorLayerSummary& InArraySerializer);
+	void PostReplicatedChange(const FParallelBehaviorLayerSummary& InArraySerializer);
+};
+
+/**
+ * @struct FParallelBehaviorLayerSummary
+ * @brief Delta serialized list of every layer of a manager, see UParallelBehaviorManagerComponent::bReplicateLayerSummary
+ */
+USTRUCT()
+struct PARALLELBEHAVIOR_API FParallelBehaviorLayerSummary : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FParallelBehaviorLayerSummaryItem> Items;
+
+	/** Manager notified of replicated changes on clients, set in its PostInitProperties */
+	UPROPERTY(NotReplicated, Transient)
+	TObjectPtr<UParallelBehaviorManagerComponent> Owner = nullptr;
+
+public:
+	/** Item of a layer, nullptr if the summary has none */
+	const FParallelBehaviorLayerSummaryItem* Find(const FName& InId) const
+	{
+		return Items.FindByPredicate([&InId](const FParallelBehaviorLayerSummaryItem& InItem) { return InItem.Id == InId; });
+	}
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FParallelBehaviorLayerSummaryItem, FParallelBehaviorLayerSummary>(Items, DeltaParms, *this);
+	}
+};
+
+template <>
+struct TStructOpsTypeTraits<FParallelBehaviorLayerSummary> : public TStructOpsTypeTraitsBase2<FParallelBehaviorLayerSummary>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
\ No newline at end of file
@@ -0,0 +1,70 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "ParallelBehaviorMessage.generated.h"
+
+class UBehaviorTreeComponent;
+class UBTDecorator;
+class UParallelBehaviorManagerComponent;
+
+/**
+ * @struct FParallelBehaviorMessage
+ * @brief Small fixed-size message exchanged between the layers of one manager
+ *
+ * Messages are copied into the manager's ring buffer, posting and receiving them never allocates.
+ */
+USTRUCT(BlueprintType)
+struct PARALLELBEHAVIOR_API FParallelBehaviorMessage
+{
+	GENERATED_BODY()
+
+	/** Kind of message, layers subscribe to it (and its parent tags) through FParallelBehaviorSetup::MessageTags */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGameplayTag Type;
+
+	/** Layer Id of the sender, filled by the plugin's Post Message task */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName Sender = NAME_None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float FloatValue = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 IntValue = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector VectorValue = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TObjectPtr<UObject> ObjectValue = nullptr;
+};
+
+/**
+ * @struct FParallelBehaviorMessageWatcher
+ * @brief Decorator re-evaluated whenever a message is posted to its layer
+ */
+struct FParallelBehaviorMessageWatcher
+{
+	TWeakObjectPtr<UBehaviorTreeComponent> TreeComponent;
+	const UBTDecorator* Decorator = nullptr;
+};
+
+/**
+ * @struct FParallelBehaviorLayerNodeMemory
+ * @brief Node memory of plugin BT nodes, caches the manager and layer Id of the tree the node runs in
+ */
+struct PARALLELBEHAVIOR_API FParallelBehaviorLayerNodeMemory
+{
+	TWeakObjectPtr<UParallelBehaviorManagerComponent> Manager;
+	FName LayerId = NAME_None;
+
+	/**
+	 * Finds the manager running the tree on first use.
+	 *
+	 * @return Manager of the tree, nullptr for trees not run by a UParallelBehaviorManagerComponent.
+	 */
+	UParallelBehaviorManagerComponent* Resolve(const UBehaviorTreeComponent& InTree);
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "ParallelBehaviorSettings.generated.h"
+
+/**
+ * @class UParallelBehaviorSettings
+ * @brief Project wide settings of the Parallel Behavior plugin (Project Settings -> Plugins -> Parallel Behavior)
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Parallel Behavior"))
+class PARALLELBEHAVIOR_API UParallelBehaviorSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UParallelBehaviorSettings();
+
+public:
+	/**
+	 * Time budget in milliseconds the world subsystem may spend per frame ticking managed trees.
+	 * Trees that did not fit into the budget are carried over to the next frame (round-robin).
+	 * 0 or less means unlimited.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Managed Tick", meta = (Units = "ms"))
+	float ManagedTickBudgetMs = 2.0f;
+
+	/**
+	 * Seconds a due managed tree has to wait past its due time to sort one priority level higher, so lower priority
+	 * trees deferred frame after frame by a tight budget eventually tick ahead of higher ones. 0 or less orders strictly
+	 * by priority, which can starve low priority trees while the budget stays exhausted.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Managed Tick", meta = (Units = "s"))
+	float PriorityAgingSeconds = 0.25f;
+
+	/** Evaluate tick conditions of thread-safe layers on worker threads, off evaluates them on the game thread */
+	UPROPERTY(Config, EditAnywhere, Category = "Managed Tick")
+	bool bParallelTickConditions = true;
+
+	/** Minimum number of tick conditions handed to one worker, small batches are not worth the scheduling cost */
+	UPROPERTY(Config, EditAnywhere, Category = "Managed Tick", meta = (ClampMin = "1", EditCondition = "bParallelTickConditions"))
+	int32 TickConditionBatchSize = 32;
+
+	/** Maximum number of queued trees started per frame, 0 or less means unlimited */
+	UPROPERTY(Config, EditAnywhere, Category = "Spawn Queue")
+	int32 MaxSpawnsPerFrame = 8;
+
+	/**
+	 * Time budget in milliseconds spent per frame starting queued trees, at least one is started every frame.
+	 * 0 or less means unlimited.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Spawn Queue", meta = (Units = "ms"))
+	float SpawnBudgetMs = 1.0f;
+
+	/**
+	 * Maximum number of BT / Blackboard components destroyed per frame by bulk teardown (TeardownTrees, EmptyPool).
+	 * The rest waits for the next frames. 0 or less destroys everything in the same frame.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Teardown")
+	int32 MaxComponentDestroysPerFrame = 32;
+
+	/**
+	 * Start every game world in step mode, layers then only advance through UParallelBehaviorSubsystem::StepAll.
+	 * Meant for fixed rate server simulation and reproducible benchmarks.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Stepping")
+	bool bStepMode = false;
+
+	/** Seed of the random tick phases in step mode */
+	UPROPERTY(Config, EditAnywhere, Category = "Stepping")
+	int32 StepRandomSeed = 0;
+
+	/** Maximum number of layers ticked per StepAll, the rest is carried over to the next step. 0 or less means unlimited */
+	UPROPERTY(Config, EditAnywhere, Category = "Stepping")
+	int32 MaxLayerTicksPerStep = 0;
+
+	/** Seconds between two LOD evaluations of the managers that have LOD enabled */
+	UPROPERTY(Config, EditAnywhere, Category = "LOD", meta = (ClampMin = "0", Units = "s"))
+	float LODUpdateInterval = 0.5f;
+
+public:
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+};
\ No newline at end of file
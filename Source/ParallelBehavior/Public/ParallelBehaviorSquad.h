@@ -0,0 +1,57 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "ParallelBehaviorSquad.generated.h"
+
+class UBlackboardComponent;
+class UParallelBehaviorManagerComponent;
+
+/**
+ * @class UParallelBehaviorSquad
+ * @brief Blackboard shared by several managers, for group level facts (objective, formation anchor, sightings)
+ *
+ * Writers set a value once on GetBlackboard(), the squad forwards the change to every member, which
+ * mirrors it into the layer keys with the same name and type (see UParallelBehaviorManagerComponent::SquadKeys)
+ * through the same routing as the manager's shared blackboard. Created through UParallelBehaviorSubsystem::FindOrCreateSquad.
+ */
+UCLASS(BlueprintType)
+class PARALLELBEHAVIOR_API UParallelBehaviorSquad : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Creates the squad blackboard and starts observing its keys */
+	bool Initialize(const FName& InSquadId, UBlackboardData& InAsset);
+
+	/** Stops observing, members are removed */
+	void Release();
+
+	/** Called by UParallelBehaviorManagerComponent::JoinSquad / LeaveSquad */
+	void AddMember(UParallelBehaviorManagerComponent* InManager);
+	void RemoveMember(UParallelBehaviorManagerComponent* InManager);
+
+	/** Blackboard holding the squad values, write them here */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, BlueprintPure, Category = "Squad")
+	UBlackboardComponent* GetBlackboard() const { return Blackboard; }
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Squad")
+	FName GetSquadId() const { return SquadId; }
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Squad")
+	int32 GetNumMembers() const { return Members.Num(); }
+
+protected:
+	/** Forwards a changed value to every member */
+	EBlackboardNotificationResult OnKeyChanged(const UBlackboardComponent& InBlackboard, FBlackboard::FKey InKey);
+
+	UPROPERTY(Transient)
+	TObjectPtr<UBlackboardComponent> Blackboard = nullptr;
+
+	FName SquadId = NAME_None;
+
+	TArray<TWeakObjectPtr<UParallelBehaviorManagerComponent>> Members;
+};
\ No newline at end of file
@@ -0,0 +1,34 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+/** "stat ParallelBehavior" */
+DECLARE_STATS_GROUP(TEXT("ParallelBehavior"), STATGROUP_ParallelBehavior, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AddTree"), STAT_ParallelBehavior_AddTree, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RemoveTree"), STAT_ParallelBehavior_RemoveTree, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Blackboard Init"), STAT_ParallelBehavior_BlackboardInit, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Managed Tick"), STAT_ParallelBehavior_ManagedTick, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick Conditions"), STAT_ParallelBehavior_TickConditions, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update LODs"), STAT_ParallelBehavior_UpdateLODs, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Processors"), STAT_ParallelBehavior_Processors, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Trees"), STAT_ParallelBehavior_ActiveTrees, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Managed Ticks"), STAT_ParallelBehavior_ManagedTicks, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deferred Ticks"), STAT_ParallelBehavior_DeferredTicks, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Skipped Ticks"), STAT_ParallelBehavior_SkippedTicks, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Processor Layers"), STAT_ParallelBehavior_ProcessorLayers, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Pairs"), STAT_ParallelBehavior_PooledPairs, STATGROUP_ParallelBehavior, PARALLELBEHAVIOR_API);
+
+/** Insights channel of the plugin, enable with -trace=cpu,ParallelBehavior */
+UE_TRACE_CHANNEL_EXTERN(ParallelBehaviorChannel, PARALLELBEHAVIOR_API);
+
+/** Cycle stat scope that also shows up as a CPU event on the ParallelBehavior trace channel */
+#define PARALLEL_BEHAVIOR_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, ParallelBehaviorChannel)
\ No newline at end of file
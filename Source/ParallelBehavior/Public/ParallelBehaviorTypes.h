@@ -0,0 +1,56 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @struct FParallelBehaviorLayerHandle
+ * @brief Stable reference to a layer in the UParallelBehaviorSubsystem registry
+ *
+ * The slot is reused after a layer is unregistered, the serial tells stale handles apart.
+ */
+struct FParallelBehaviorLayerHandle
+{
+	int32 Slot = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsValid() const { return Slot != INDEX_NONE; }
+	void Reset() { Slot = INDEX_NONE; Serial = 0; }
+
+	bool operator==(const FParallelBehaviorLayerHandle& Other) const { return Slot == Other.Slot && Serial == Other.Serial; }
+	bool operator!=(const FParallelBehaviorLayerHandle& Other) const { return !(*this == Other); }
+};
+
+/**
+ * @struct FParallelBehaviorProcessorHandle
+ * @brief Stable reference to a processor layer, see UParallelBehaviorProcessor
+ */
+struct FParallelBehaviorProcessorHandle
+{
+	/** Index of the processor class batch in UParallelBehaviorSubsystem */
+	int32 Batch = INDEX_NONE;
+	int32 Slot = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsValid() const { return Slot != INDEX_NONE; }
+	void Reset() { Batch = INDEX_NONE; Slot = INDEX_NONE; Serial = 0; }
+};
+
+/**
+ * @enum EParallelBehaviorLayerFlags
+ * @brief State bits stored per layer in the subsystem registry
+ */
+enum class EParallelBehaviorLayerFlags : uint8
+{
+	None = 0,
+	/** Layer is ticked by the subsystem scheduler */
+	ManagedTick = 1 << 0,
+	/** Layer is paused, the scheduler skips it */
+	Paused = 1 << 1,
+	/** Tick condition of the layer may be evaluated on worker threads */
+	ThreadSafe = 1 << 2,
+	/** Layer sleeps until woken by an event, the scheduler skips it */
+	Sleeping = 1 << 3,
+};
+ENUM_CLASS_FLAGS(EParallelBehaviorLayerFlags);
\ No newline at end of file
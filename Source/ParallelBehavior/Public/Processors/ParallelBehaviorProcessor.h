@@ -0,0 +1,189 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "StructUtils/InstancedStruct.h"
+#include "ParallelBehaviorTypes.h"
+#include "ParallelBehaviorProcessor.generated.h"
+
+class UParallelBehaviorManagerComponent;
+
+/**
+ * @struct FParallelBehaviorFragmentView
+ * @brief Range of packed processor layers handed to UParallelBehaviorProcessor::Execute
+ */
+struct PARALLELBEHAVIOR_API FParallelBehaviorFragmentView
+{
+	uint8* Fragments = nullptr;
+	int32 Stride = 0;
+	int32 Count = 0;
+	const TWeakObjectPtr<UParallelBehaviorManagerComponent>* Managers = nullptr;
+	const FName* LayerIds = nullptr;
+	const bool* Paused = nullptr;
+
+public:
+	int32 Num() const { return Count; }
+
+	/** Fragment of the layer at the given index, T must be the processor's fragment type */
+	template <typename T>
+	T& Get(int32 InIndex) const
+	{
+		check(InIndex >= 0 && InIndex < Count);
+		return *reinterpret_cast<T*>(Fragments + InIndex * Stride);
+	}
+
+	/** Paused layers are part of the range, processors skip them */
+	bool IsPaused(int32 InIndex) const { return Paused[InIndex]; }
+
+	FName GetLayerId(int32 InIndex) const { return LayerIds[InIndex]; }
+
+	/** Manager owning the layer, game thread only */
+	UParallelBehaviorManagerComponent* GetManager(int32 InIndex) const { return Managers[InIndex].Get(); }
+
+	/** Sub range starting at InStart */
+	FParallelBehaviorFragmentView Slice(int32 InStart, int32 InCount) const;
+};
+
+/**
+ * @struct FParallelBehaviorProcessorContext
+ * @brief Frame data shared by every range of one processor execution
+ */
+struct FParallelBehaviorProcessorContext
+{
+	UWorld* World = nullptr;
+
+	/** Seconds since the processor last executed */
+	float DeltaTime = 0.0f;
+
+	/** World time of this execution */
+	double Time = 0.0;
+};
+
+/**
+ * @class UParallelBehaviorProcessor
+ * @brief Lightweight layer backend, runs one function over the packed fragments of every layer using it
+ *
+ * A processor layer has no BT or Blackboard component. Its state is one FragmentType struct stored
+ * next to the fragments of every other layer with the same processor class in the world, and
+ * Execute walks them in one pass. Meant for background crowd agents that need layered behavior
+ * at a fraction of the cost of a behavior tree.
+ *
+ * Subclasses set FragmentType in their constructor and implement Execute. Only the class default
+ * object is used, processors must not keep per layer state in members.
+ */
+UCLASS(Abstract)
+class PARALLELBEHAVIOR_API UParallelBehaviorProcessor : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Seconds between executions, every layer of the processor executes together. 0 executes every frame */
+	UPROPERTY(EditDefaultsOnly, Category = "Processor", meta = (ClampMin = "0", Units = "s"))
+	float TickInterval = 0.0f;
+
+	/** Execute only touches the fragments and may run on worker threads, split into ranges of BatchSize layers */
+	UPROPERTY(EditDefaultsOnly, Category = "Processor")
+	bool bThreadSafe = false;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Processor", meta = (ClampMin = "1", EditCondition = "bThreadSafe"))
+	int32 BatchSize = 256;
+
+public:
+	/** Struct of the per layer state, packed per processor class */
+	const UScriptStruct* GetFragmentType() const { return FragmentType; }
+
+	/**
+	 * Called on the game thread when a layer is added, after its fragment was initialized from the setup.
+	 *
+	 * @param InView Range holding only the new layer.
+	 */
+	virtual void InitializeFragment(const FParallelBehaviorFragmentView& InView) const {}
+
+	/** Advances a range of layers, on a worker thread when bThreadSafe is set */
+	virtual void Execute(const FParallelBehaviorProcessorContext& InContext, const FParallelBehaviorFragmentView& InView) const
+		PURE_VIRTUAL(UParallelBehaviorProcessor::Execute, );
+
+protected:
+	UPROPERTY()
+	TObjectPtr<const UScriptStruct> FragmentType = nullptr;
+};
+
+/**
+ * @struct FParallelBehaviorProcessorBatch
+ * @brief Packed fragments of every layer of one processor class in a world
+ *
+ * Arrays are dense, removal moves the last layer into the freed index. Fragments are relocated
+ * with memcpy like any TArray element, handles address layers through a slot table.
+ * Object references held by fragment properties are reported to the GC through AddReferencedObjects.
+ */
+struct PARALLELBEHAVIOR_API FParallelBehaviorProcessorBatch
+{
+	/** Class default object of the processor */
+	const UParallelBehaviorProcessor* Processor = nullptr;
+
+	const UScriptStruct* FragmentType = nullptr;
+
+	/** Bytes between two fragments */
+	int32 Stride = 0;
+
+	TArray<uint8, TAlignedHeapAllocator<16>> Fragments;
+
+	TArray<TWeakObjectPtr<UParallelBehaviorManagerComponent>> Managers;
+
+	TArray<FName> LayerIds;
+
+	TArray<bool> Paused;
+
+	/** World time the processor executed last, negative before the first execution */
+	double LastTickTime = -1.0;
+
+	/** World time the processor is due again */
+	double NextTickTime = 0.0;
+
+public:
+	FParallelBehaviorProcessorBatch() = default;
+	FParallelBehaviorProcessorBatch(FParallelBehaviorProcessorBatch&&) = default;
+	FParallelBehaviorProcessorBatch& operator=(FParallelBehaviorProcessorBatch&&) = default;
+	~FParallelBehaviorProcessorBatch();
+
+	int32 Num() const { return LayerIds.Num(); }
+
+	/**
+	 * Appends a layer, its fragment is copied from InInitialFragment when it has the fragment type.
+	 *
+	 * @return Slot and serial of the new layer.
+	 */
+	FParallelBehaviorProcessorHandle Add(int32 InBatchIndex, UParallelBehaviorManagerComponent* InManager, const FName& InLayerId,
+		const FInstancedStruct& InInitialFragment);
+
+	/** Removes the layer behind the handle, returns false for stale handles */
+	bool Remove(const FParallelBehaviorProcessorHandle& InHandle);
+
+	/** Dense index of the layer behind the handle, INDEX_NONE for stale handles */
+	int32 IndexOf(const FParallelBehaviorProcessorHandle& InHandle) const;
+
+	/** Fragment at a dense index */
+	uint8* GetFragment(int32 InIndex) { return Fragments.GetData() + InIndex * Stride; }
+
+	/** Every layer, or the one at InIndex */
+	FParallelBehaviorFragmentView MakeView() const;
+	FParallelBehaviorFragmentView MakeView(int32 InIndex) const;
+
+	/** Destroys every fragment, handles issued before become stale */
+	void Empty();
+
+	/** Reports the processor, the fragment type and every object referenced by a fragment property */
+	void AddReferencedObjects(FReferenceCollector& Collector, const UObject* InReferencer);
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	void RemoveAt(int32 InIndex);
+
+	TArray<int32> SlotToIndex;
+	TArray<uint32> SlotSerials;
+	TArray<int32> IndexToSlot;
+	TArray<int32> FreeSlots;
+};
\ No newline at end of file
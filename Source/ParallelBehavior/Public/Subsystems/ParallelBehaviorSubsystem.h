@@ -0,0 +1,512 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParallelBehaviorDebug.h"
+#include "ParallelBehaviorTypes.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Components/ParallelBehaviorManagerComponent.h"
+#include "Processors/ParallelBehaviorProcessor.h"
+#include "UObject/ObjectKey.h"
+#include "ParallelBehaviorSubsystem.generated.h"
+
+class UBehaviorTreeComponent;
+class UBlackboardComponent;
+class UParallelBehaviorManagerComponent;
+class UParallelBehaviorSquad;
+class UParallelBehaviorTickCondition;
+struct FParallelBehaviorLayerStats;
+
+/**
+ * @struct FParallelBehaviorLayerRegistry
+ * @brief Structure-of-arrays storage of every layer of every manager in a world
+ *
+ * All arrays are dense and indexed by the same layer index, removal swaps the last layer into the
+ * freed index. Handles address layers through a slot table so they survive the swap.
+ */
+struct PARALLELBEHAVIOR_API FParallelBehaviorLayerRegistry
+{
+	/** Manager owning the layer */
+	TArray<TWeakObjectPtr<UParallelBehaviorManagerComponent>> Agents;
+
+	/** FParallelBehaviorSetup::Id of the layer */
+	TArray<FName> LayerIds;
+
+	TArray<TWeakObjectPtr<UBehaviorTreeComponent>> TreeComponents;
+
+	TArray<TWeakObjectPtr<UBlackboardComponent>> Blackboards;
+
+	TArray<EParallelBehaviorLayerFlags> Flags;
+
+	/** Higher priority layers are ticked first when the budget runs out */
+	TArray<int32> Priorities;
+
+	/** Seconds between managed ticks, 0 ticks every frame */
+	TArray<float> TickIntervals;
+
+	/** World time of the last managed tick, the next tick receives the time elapsed since then */
+	TArray<double> LastTickTimes;
+
+	/** World time at which the layer is due again */
+	TArray<double> NextTickTimes;
+
+	/** Gate checked before each managed tick, null ticks unconditionally */
+	TArray<TWeakObjectPtr<const UParallelBehaviorTickCondition>> TickConditions;
+
+	/** Keys resolved by the tick condition against the layer's blackboard */
+	TArray<TArray<FBlackboard::FKey>> TickConditionKeys;
+
+	/** Managed ticks since the layer was registered */
+	TArray<uint32> TickCounts;
+
+	/** CPU cycles of the last managed tick */
+	TArray<uint64> LastTickCycles;
+
+	/** CPU cycles of every managed tick since the layer was registered */
+	TArray<uint64> TotalTickCycles;
+
+#if STATS
+	/** Cycle stat of the layer, shared by every layer with the same Id (generated Ids share their asset's stat) */
+	TArray<TStatId> StatIds;
+#endif
+
+#if PARALLEL_BEHAVIOR_DEBUG
+	/** Cost of the last managed ticks, shown by the gameplay debugger */
+	TArray<FParallelBehaviorTickHistory> TickHistories;
+#endif
+
+public:
+	int32 Num() const { return LayerIds.Num(); }
+
+	/** Appends a layer and returns its handle */
+	FParallelBehaviorLayerHandle Add(UParallelBehaviorManagerComponent* InAgent, const FName& InLayerId,
+		UBehaviorTreeComponent* InTreeComponent, UBlackboardComponent* InBlackboard);
+
+	/** Swap-removes the layer behind the handle, returns false for stale handles */
+	bool Remove(const FParallelBehaviorLayerHandle& InHandle);
+
+	/** Swap-removes the layer at a dense index */
+	void RemoveAt(int32 InIndex);
+
+	/** Dense index of the layer behind the handle, INDEX_NONE for stale handles */
+	int32 IndexOf(const FParallelBehaviorLayerHandle& InHandle) const;
+
+	/** Handle of the layer at a dense index */
+	FParallelBehaviorLayerHandle GetHandle(int32 InIndex) const;
+
+	void Empty();
+
+	/** Heap memory of every array of the registry */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/** Dense index owning each slot, INDEX_NONE for free slots */
+	TArray<int32> SlotToIndex;
+
+	/** Serial of each slot, bumped whenever the slot is freed */
+	TArray<uint32> SlotSerials;
+
+	/** Slot of each dense index */
+	TArray<int32> IndexToSlot;
+
+	/** Slots ready for reuse */
+	TArray<int32> FreeSlots;
+};
+
+/**
+ * @struct FParallelBehaviorConditionJob
+ * @brief One tick condition evaluation, pointers are resolved on the game thread before the batch runs
+ */
+struct FParallelBehaviorConditionJob
+{
+	/** Position of the layer in the due list */
+	int32 DueIndex = INDEX_NONE;
+	const UParallelBehaviorTickCondition* Condition = nullptr;
+	const UBlackboardComponent* Blackboard = nullptr;
+	bool bPassed = true;
+};
+
+/**
+ * @struct FParallelBehaviorSpawnRequest
+ * @brief Setup waiting in the world spawn queue, see UParallelBehaviorManagerComponent::QueueTree
+ */
+USTRUCT()
+struct FParallelBehaviorSpawnRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TWeakObjectPtr<UParallelBehaviorManagerComponent> Manager;
+
+	UPROPERTY()
+	FParallelBehaviorSetup Setup;
+
+	/** Queue order, keeps requests of equal priority first in first out */
+	uint32 Sequence = 0;
+};
+
+/**
+ * @class UParallelBehaviorSubsystem
+ * @brief World level registry of every parallel layer, and scheduler for the ones using managed tick.
+ *
+ * Managers register themselves and each of their layers. Layers live in a structure-of-arrays
+ * registry so bulk operations (scheduling, LOD, stats, world-wide pause) are tight loops instead
+ * of per-actor component walks.
+ *
+ * Managed layers do not tick on their own. Each frame the subsystem ticks every due layer,
+ * highest priority first and longest waiting first within a priority, until
+ * UParallelBehaviorSettings::ManagedTickBudgetMs is spent. The rest are carried over to the next
+ * frame and receive their accumulated delta time.
+ *
+ * Due layers with a tick condition are gated first. Conditions of thread-safe layers of every
+ * agent are evaluated together on worker threads, tree ticks and all their side effects stay on
+ * the game thread.
+ *
+ * Trees queued through UParallelBehaviorManagerComponent::QueueTree are started at most
+ * UParallelBehaviorSettings::MaxSpawnsPerFrame per frame within SpawnBudgetMs, highest SpawnPriority first.
+ *
+ * The subsystem also assigns distance based LOD levels to managers with LOD enabled.
+ *
+ * Processor layers (UParallelBehaviorProcessor) are stored packed per processor class, each class
+ * executes once per TickInterval over the fragments of every one of its layers in the world.
+ *
+ * In step mode (SetStepMode) layers and processors only advance through StepAll, on a simulation
+ * clock of their own, in a fixed order and within a layer count budget instead of a time budget.
+ */
+UCLASS()
+class PARALLELBEHAVIOR_API UParallelBehaviorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** Every registered layer of the world */
+	FParallelBehaviorLayerRegistry Layers;
+
+	/** Every registered manager of the world */
+	TArray<TWeakObjectPtr<UParallelBehaviorManagerComponent>> Managers;
+
+	/** Scratch list of due layer indices, kept to avoid reallocating every frame */
+	TArray<int32> DueLayers;
+
+	/** Priority of each due layer raised by its wait, see PriorityAgingSeconds. Indexed by registry index */
+	TArray<double> DueSortPriorities;
+
+	/**
+	 * Due layers in tick order as handles. A tick may add or remove layers (RemoveTree, tag activation...),
+	 * which swaps registry indices, so every layer is resolved again right before it ticks.
+	 */
+	TArray<FParallelBehaviorLayerHandle> DueHandles;
+
+	/** Scratch list of the tick condition pass, kept to avoid reallocating every frame */
+	TArray<FParallelBehaviorConditionJob> ConditionJobs;
+
+	/** Number of due layers whose tick condition failed last frame */
+	int32 LastSkippedTicks = 0;
+
+	/** Setups waiting to be started, sorted so the next one to start is last */
+	UPROPERTY(Transient)
+	TArray<FParallelBehaviorSpawnRequest> SpawnQueue;
+
+	/** SpawnQueue received requests since it was last sorted */
+	bool bSpawnQueueDirty = false;
+
+	/** Sequence given to the next spawn request */
+	uint32 NextSpawnSequence = 0;
+
+	/** Number of layers that did not fit into the budget last frame */
+	int32 LastDeferredTicks = 0;
+
+	/** World time of the next LOD evaluation */
+	double NextLODUpdateTime = 0.0;
+
+	/** Snapshots of managers that left the world, keyed by UParallelBehaviorManagerComponent::GetSnapshotKey */
+	UPROPERTY(Transient)
+	TMap<FName, FParallelBehaviorSnapshot> StoredSnapshots;
+
+	/** Squads by Id, see FindOrCreateSquad */
+	UPROPERTY(Transient)
+	TMap<FName, TObjectPtr<UParallelBehaviorSquad>> Squads;
+
+	/** Components handed to DeferDestroy, destroyed oldest first */
+	TArray<TWeakObjectPtr<UActorComponent>> PendingDestroys;
+
+	/** Packed processor layers, one batch per processor class */
+	TArray<FParallelBehaviorProcessorBatch> ProcessorBatches;
+
+	/** Index in ProcessorBatches per processor class */
+	TMap<TObjectKey<UClass>, int32> ProcessorBatchByClass;
+
+#if STATS
+	/** Cycle stat per layer Id, created on first use */
+	TMap<FName, TStatId> LayerStatIds;
+#endif
+
+	/** Every layer of the world is paused */
+	bool bWorldPaused = false;
+
+	/** Layers only advance through StepAll */
+	bool bStepMode = false;
+
+	/** Simulation clock of step mode, replaces the world time in the scheduler */
+	double StepTime = 0.0;
+
+	/** Random tick phases in step mode, seeded so runs are reproducible */
+	FRandomStream StepRandom;
+
+public:
+	/** Adds a manager to the world registry */
+	void RegisterManager(UParallelBehaviorManagerComponent* InManager);
+
+	/** Removes a manager from the world registry, its layers must be unregistered separately */
+	void UnregisterManager(UParallelBehaviorManagerComponent* InManager);
+
+	/** Adds a setup to the spawn queue, the manager's StartQueuedTree is called once its turn comes */
+	void EnqueueSpawn(UParallelBehaviorManagerComponent* InManager, const FParallelBehaviorSetup& InSetup);
+
+	/** Drops every queued setup of a manager, returns how many were dropped */
+	int32 CancelSpawns(const UParallelBehaviorManagerComponent* InManager);
+
+	/** Number of setups waiting in the spawn queue */
+	int32 GetNumQueuedSpawns() const { return SpawnQueue.Num(); }
+
+	/**
+	 * Adds a layer to the registry.
+	 * The layer ticks on its own until SetLayerManagedTick() hands it over to the scheduler.
+	 *
+	 * @return Handle used for every later call about this layer.
+	 */
+	FParallelBehaviorLayerHandle RegisterLayer(UParallelBehaviorManagerComponent* InManager, const FName& InLayerId,
+		UBehaviorTreeComponent* InTreeComponent, UBlackboardComponent* InBlackboard);
+
+	/** Removes a layer from the registry, the handle is reset */
+	void UnregisterLayer(FParallelBehaviorLayerHandle& InOutHandle);
+
+	/**
+	 * Hands ticking of the layer over to the scheduler.
+	 * The tree component must have its own tick disabled.
+	 *
+	 * @param InTickInterval Seconds between ticks, 0 ticks every frame.
+	 * @param InPriority Higher priority layers are ticked first when the budget runs out.
+	 * @param bInRandomPhase Delay the first tick by a random fraction of the interval to spread layers started on the same frame.
+	 */
+	void SetLayerManagedTick(const FParallelBehaviorLayerHandle& InHandle, float InTickInterval, int32 InPriority, bool bInRandomPhase);
+
+	/** Changes tick interval and priority of a layer, returns false for stale handles */
+	bool SetLayerTickSettings(const FParallelBehaviorLayerHandle& InHandle, float InTickInterval, int32 InPriority);
+
+	/** Tick interval of a layer, 0 for stale handles */
+	float GetLayerTickInterval(const FParallelBehaviorLayerHandle& InHandle) const;
+
+	/**
+	 * Sets the gate checked before each managed tick of the layer, null removes it.
+	 * Keys are resolved against the layer's blackboard right away.
+	 *
+	 * @param bInThreadSafe The condition only reads the blackboard and may be evaluated on worker threads.
+	 * @return false for stale handles.
+	 */
+	bool SetLayerTickCondition(const FParallelBehaviorLayerHandle& InHandle, const UParallelBehaviorTickCondition* InCondition, bool bInThreadSafe);
+
+	/** Skips or resumes scheduling a layer, returns false for stale handles */
+	bool SetLayerPaused(const FParallelBehaviorLayerHandle& InHandle, bool bInPaused);
+
+	/** Puts a layer to sleep or wakes it, sleeping layers are skipped like paused ones. Returns false for stale handles */
+	bool SetLayerSleeping(const FParallelBehaviorLayerHandle& InHandle, bool bInSleeping);
+
+	/**
+	 * Adds a layer run by a processor instead of a behavior tree.
+	 *
+	 * @param InInitialFragment Initial state of the layer, ignored unless it has the processor's fragment type.
+	 * @return Handle used for every later call about this layer, invalid if the processor has no fragment type.
+	 */
+	FParallelBehaviorProcessorHandle AddProcessorLayer(UParallelBehaviorManagerComponent* InManager, const FName& InLayerId,
+		TSubclassOf<UParallelBehaviorProcessor> InProcessor, const FInstancedStruct& InInitialFragment);
+
+	/** Removes a processor layer, the handle is reset */
+	void RemoveProcessorLayer(FParallelBehaviorProcessorHandle& InOutHandle);
+
+	/** Skips or resumes a processor layer, returns false for stale handles */
+	bool SetProcessorLayerPaused(const FParallelBehaviorProcessorHandle& InHandle, bool bInPaused);
+
+	/** Whether a processor layer is paused, false for stale handles */
+	bool IsProcessorLayerPaused(const FParallelBehaviorProcessorHandle& InHandle) const;
+
+	/**
+	 * Fragment of a processor layer, valid until a layer of the same processor is added or removed.
+	 *
+	 * @param OutType Fragment type of the processor.
+	 * @return nullptr for stale handles.
+	 */
+	uint8* GetProcessorFragment(const FParallelBehaviorProcessorHandle& InHandle, const UScriptStruct*& OutType);
+
+	/** Batch holding a processor layer, nullptr for stale handles */
+	const FParallelBehaviorProcessorBatch* GetProcessorBatch(const FParallelBehaviorProcessorHandle& InHandle) const;
+
+	/** Number of processor layers in the world */
+	int32 GetNumProcessorLayers() const;
+
+	/**
+	 * Keeps the snapshot of a manager leaving the world, e.g. with a streamed out level.
+	 * An existing snapshot with the same key is replaced.
+	 */
+	void StoreSnapshot(const FName& InKey, FParallelBehaviorSnapshot&& InSnapshot);
+
+	/**
+	 * Moves a stored snapshot out of the subsystem.
+	 *
+	 * @return false if no snapshot is stored under the key.
+	 */
+	bool TakeSnapshot(const FName& InKey, FParallelBehaviorSnapshot& OutSnapshot);
+
+	/**
+	 * Squad with the given Id, created with InBlackboardAsset when none exists yet.
+	 * Squads live until RemoveSquad or the end of the world.
+	 *
+	 * @return nullptr if the squad does not exist and no asset was given.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Parallel Behavior")
+	UParallelBehaviorSquad* FindOrCreateSquad(FName InSquadId, UBlackboardData* InBlackboardAsset);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Parallel Behavior")
+	UParallelBehaviorSquad* FindSquad(FName InSquadId) const;
+
+	/** Releases a squad, its members leave it */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Parallel Behavior")
+	void RemoveSquad(FName InSquadId);
+
+	/** Drops every stored snapshot */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Parallel Behavior")
+	void ClearSnapshots() { StoredSnapshots.Empty(); }
+
+	/**
+	 * Pauses or resumes every layer of every manager in the world.
+	 * Layers added while the world is paused start paused.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Parallel Behavior")
+	void SetWorldPaused(bool bInPaused);
+
+	/**
+	 * Tears every manager of the world down at once, see UParallelBehaviorManagerComponent::TeardownTrees.
+	 * Queued spawns are dropped as well. Meant for level transitions and mass despawns.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Parallel Behavior")
+	void TeardownAllManagers();
+
+	/**
+	 * Destroys a component within the next frames instead of now, at most MaxComponentDestroysPerFrame per frame.
+	 * The component stops ticking right away.
+	 */
+	void DeferDestroy(UActorComponent* InComponent);
+
+	/** Number of components waiting for their deferred destruction */
+	int32 GetNumPendingDestroys() const { return PendingDestroys.Num(); }
+
+	/**
+	 * Detaches layers from engine ticks, they advance only through StepAll. Every running and future
+	 * tree layer is driven by the scheduler while step mode is on.
+	 *
+	 * @param InRandomSeed Seed of the random tick phases, identical seeds and workloads give identical runs.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Parallel Behavior")
+	void SetStepMode(bool bInEnabled, int32 InRandomSeed = 0);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Parallel Behavior")
+	bool IsStepMode() const { return bStepMode; }
+
+	/**
+	 * Advances the simulation clock of step mode and ticks every due layer and processor, highest priority first.
+	 * At most UParallelBehaviorSettings::MaxLayerTicksPerStep layers tick, the rest is carried over to the next
+	 * step in the same deterministic order.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Parallel Behavior")
+	void StepAll(float DeltaTime);
+
+	/** Time the scheduler works with, the step clock in step mode and the world time otherwise */
+	double GetSchedulerTime() const;
+
+	/** Whether every layer of the world is paused */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Parallel Behavior")
+	bool IsWorldPaused() const { return bWorldPaused; }
+
+	/** Read-only access to the layer registry for bulk queries */
+	const FParallelBehaviorLayerRegistry& GetLayers() const { return Layers; }
+
+	/** Number of registered layers */
+	int32 GetNumLayers() const { return Layers.Num(); }
+
+	/**
+	 * Fills tick count and timings of a layer into OutStats, other fields are left untouched.
+	 *
+	 * @return false for stale handles.
+	 */
+	bool GetLayerStats(const FParallelBehaviorLayerHandle& InHandle, FParallelBehaviorLayerStats& OutStats) const;
+
+#if PARALLEL_BEHAVIOR_DEBUG
+	/** Cost of the last managed ticks of a layer, nullptr for stale handles */
+	const FParallelBehaviorTickHistory* GetLayerTickHistory(const FParallelBehaviorLayerHandle& InHandle) const;
+#endif
+
+	/** Number of layers carrying all the given flags */
+	int32 CountLayers(EParallelBehaviorLayerFlags InFlags) const;
+
+	/** Number of layers that were carried over to this frame */
+	int32 GetLastDeferredTicks() const { return LastDeferredTicks; }
+
+	/** Number of due layers skipped by their tick condition last frame */
+	int32 GetLastSkippedTicks() const { return LastSkippedTicks; }
+
+	/** Memory of every registered manager summed up, plus the layer registry, see pb.MemReport */
+	UFUNCTION(BlueprintCallable, Category = "Parallel Behavior")
+	FParallelBehaviorMemoryStats GetMemoryStats() const;
+
+	/** Every registered manager that is still alive */
+	void GetManagers(TArray<UParallelBehaviorManagerComponent*>& OutManagers) const;
+
+protected:
+	/** Starts queued setups within the spawn budget */
+	void ProcessSpawnQueue();
+
+	/** Destroys deferred components within the per frame limit */
+	void ProcessPendingDestroys();
+
+	/**
+	 * Ticks due managed layers within the frame budget.
+	 *
+	 * @param InMaxTicks Tick at most this many layers and ignore the time budget, 0 or less is unlimited.
+	 * @param bInTimeBudget Stop once ManagedTickBudgetMs is spent when InMaxTicks is unlimited. Step mode passes false,
+	 *                      a wall clock budget would make the ticked layers depend on the machine.
+	 */
+	void TickManagedLayers(double InNow, int32 InMaxTicks = 0, bool bInTimeBudget = true);
+
+	/**
+	 * Executes every processor that is due over the fragments of its layers.
+	 *
+	 * @param InFirstDeltaTime Delta time of a processor's first execution.
+	 */
+	void TickProcessors(double InNow, float InFirstDeltaTime);
+
+	/**
+	 * Evaluates tick conditions of the due layers and drops the ones that failed from DueLayers.
+	 * Thread-safe conditions run as one ParallelFor batch, results are applied on the game thread in layer order.
+	 */
+	void FilterDueLayersByCondition(double InNow);
+
+	/** Sets or clears a flag that holds the layer back from scheduling */
+	bool SetLayerHoldFlag(const FParallelBehaviorLayerHandle& InHandle, EParallelBehaviorLayerFlags InFlag, bool bInSet);
+
+	/** Assigns a LOD level to every manager with LOD enabled from the distance to the closest player viewpoint */
+	void UpdateLODs();
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Keeps objects referenced from processor fragments alive, see FParallelBehaviorProcessorBatch */
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
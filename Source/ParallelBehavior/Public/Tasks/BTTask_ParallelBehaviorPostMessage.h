@@ -0,0 +1,49 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "GameplayTagContainer.h"
+#include "BTTask_ParallelBehaviorPostMessage.generated.h"
+
+/**
+ * @class UBTTask_ParallelBehaviorPostMessage
+ * @brief Posts a message from this layer to another layer of the same manager
+ *
+ * Payload values are read from the optional blackboard keys. Fails when nobody received the message.
+ */
+UCLASS(meta = (DisplayName = "Parallel Post Message"))
+class PARALLELBEHAVIOR_API UBTTask_ParallelBehaviorPostMessage : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_ParallelBehaviorPostMessage();
+
+	UPROPERTY(EditAnywhere, Category = "Message")
+	FGameplayTag MessageType;
+
+	/** Receiving layer Id, none delivers to every layer subscribed to MessageType */
+	UPROPERTY(EditAnywhere, Category = "Message")
+	FName TargetLayer = NAME_None;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector FloatKey;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector IntKey;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector VectorKey;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector ObjectKey;
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+};
\ No newline at end of file
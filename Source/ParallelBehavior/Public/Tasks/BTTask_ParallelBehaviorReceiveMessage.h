@@ -0,0 +1,49 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "GameplayTagContainer.h"
+#include "BTTask_ParallelBehaviorReceiveMessage.generated.h"
+
+/**
+ * @class UBTTask_ParallelBehaviorReceiveMessage
+ * @brief Takes the oldest message waiting for this layer and writes its payload into the optional blackboard keys
+ *
+ * Fails when no matching message is waiting.
+ */
+UCLASS(meta = (DisplayName = "Parallel Receive Message"))
+class PARALLELBEHAVIOR_API UBTTask_ParallelBehaviorReceiveMessage : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_ParallelBehaviorReceiveMessage();
+
+	/** Message type to receive (child tags match too), empty receives any message */
+	UPROPERTY(EditAnywhere, Category = "Message")
+	FGameplayTag MessageType;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector SenderKey;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector FloatKey;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector IntKey;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector VectorKey;
+
+	UPROPERTY(EditAnywhere, Category = "Payload")
+	FBlackboardKeySelector ObjectKey;
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+﻿// © Artem Podorozhko. All Rights Reserved. This project, including all associated assets, code, and content, is the property of Artem Podorozhko. Unauthorized use, distribution, or modification is strictly prohibited.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_ParallelBehaviorSleep.generated.h"
+
+class UParallelBehaviorManagerComponent;
+
+struct FBTParallelBehaviorSleepMemory
+{
+	TWeakObjectPtr<UParallelBehaviorManagerComponent> Manager;
+	FName LayerId = NAME_None;
+};
+
+/**
+ * @class UBTTask_ParallelBehaviorSleep
+ * @brief Puts the running parallel layer to sleep until one of its wake events fires
+ *
+ * The layer costs no tick while sleeping. Once woken (WakeKeys, WakeTags, WakeTree) the task succeeds
+ * and the tree continues after it. Succeeds immediately in trees not run by a UParallelBehaviorManagerComponent.
+ */
+UCLASS(meta = (DisplayName = "Parallel Sleep"))
+class PARALLELBEHAVIOR_API UBTTask_ParallelBehaviorSleep : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_ParallelBehaviorSleep();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+};
\ No newline at end of file